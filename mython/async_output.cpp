@@ -0,0 +1,192 @@
+#include "async_output.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace runtime {
+
+    AsyncOutputContext::AsyncOutputContext(int fd, size_t buffer_size)
+        : fd_(fd)
+        , buffer_size_(max<size_t>(buffer_size, 1))
+        , buffers_(BUFFER_COUNT, vector<char>(buffer_size_))
+        , buffer_(*this)
+        , stream_(&buffer_) {
+        for (size_t i = 1; i < BUFFER_COUNT; ++i) {
+            free_.push_back(i);
+        }
+        char* data = buffers_[current_].data();
+        buffer_.Reset(data, data + buffer_size_);
+        writer_ = thread([this] {
+            RunWriter();
+        });
+    }
+
+    AsyncOutputContext::~AsyncOutputContext() {
+        buffer_.Submit();
+        {
+            lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        work_ready_.notify_one();
+        writer_.join();
+    }
+
+    void AsyncOutputContext::Flush() {
+        buffer_.Submit();
+        unique_lock lock(mutex_);
+        buffer_free_.wait(lock, [this] {
+            return full_.empty() && writing_ == 0;
+        });
+        if (!error_.empty()) {
+            throw runtime_error("Can't write output: "s + error_);
+        }
+    }
+
+    void AsyncOutputContext::Buffer::Submit() {
+        const size_t size = static_cast<size_t>(pptr() - pbase());
+        if (size > 0) {
+            char* data = owner_.Exchange({ owner_.current_, size });
+            Reset(data, data + owner_.buffer_size_);
+        }
+    }
+
+    void AsyncOutputContext::Buffer::Reset(char* begin, char* end) {
+        setp(begin, end);
+    }
+
+    AsyncOutputContext::Buffer::int_type AsyncOutputContext::Buffer::overflow(int_type ch) {
+        Submit();
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    streamsize AsyncOutputContext::Buffer::xsputn(const char* s, streamsize count) {
+        size_t rest = static_cast<size_t>(count);
+        while (rest > 0) {
+            if (pptr() == epptr()) {
+                Submit();
+            }
+            const size_t part = min(rest, static_cast<size_t>(epptr() - pptr()));
+            memcpy(pptr(), s, part);
+            pbump(static_cast<int>(part));
+            s += part;
+            rest -= part;
+        }
+        return count;
+    }
+
+    int AsyncOutputContext::Buffer::sync() {
+        Submit();
+        return 0;
+    }
+
+    char* AsyncOutputContext::Exchange(Chunk chunk) {
+        unique_lock lock(mutex_);
+        full_.push_back(chunk);
+        work_ready_.notify_one();
+        buffer_free_.wait(lock, [this] {
+            return !free_.empty();
+        });
+        current_ = free_.back();
+        free_.pop_back();
+        return buffers_[current_].data();
+    }
+
+    void AsyncOutputContext::RunWriter() {
+        unique_lock lock(mutex_);
+        while (true) {
+            work_ready_.wait(lock, [this] {
+                return stopping_ || !full_.empty();
+            });
+            if (full_.empty()) {
+                return;
+            }
+            const vector<Chunk> chunks(full_.begin(), full_.end());
+            full_.clear();
+            writing_ = chunks.size();
+            //    
+            const bool failed = !error_.empty();
+            lock.unlock();
+            string error = failed ? string() : Write(chunks);
+            lock.lock();
+            if (!error.empty()) {
+                error_ = std::move(error);
+            }
+            for (const Chunk& chunk : chunks) {
+                free_.push_back(chunk.index);
+            }
+            writing_ = 0;
+            buffer_free_.notify_all();
+        }
+    }
+
+#ifdef _WIN32
+
+    string AsyncOutputContext::Write(const vector<Chunk>& chunks) {
+        for (const Chunk& chunk : chunks) {
+            const char* data = buffers_[chunk.index].data();
+            size_t rest = chunk.size;
+            while (rest > 0) {
+                const int written = _write(fd_, data, static_cast<unsigned>(min<size_t>(rest, INT_MAX)));
+                if (written < 0) {
+                    return strerror(errno);
+                }
+                data += written;
+                rest -= static_cast<size_t>(written);
+            }
+        }
+        return {};
+    }
+
+#else
+
+    string AsyncOutputContext::Write(const vector<Chunk>& chunks) {
+        vector<iovec> parts;
+        parts.reserve(chunks.size());
+        for (const Chunk& chunk : chunks) {
+            parts.push_back({ buffers_[chunk.index].data(), chunk.size });
+        }
+        size_t first = 0;
+        while (first < parts.size()) {
+            const int count = static_cast<int>(min<size_t>(parts.size() - first, IOV_MAX));
+            const ssize_t written = writev(fd_, parts.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return strerror(errno);
+            }
+            //    :      
+            size_t rest = static_cast<size_t>(written);
+            while (first < parts.size() && rest >= parts[first].iov_len) {
+                rest -= parts[first].iov_len;
+                ++first;
+            }
+            if (rest > 0) {
+                parts[first].iov_base = static_cast<char*>(parts[first].iov_base) + rest;
+                parts[first].iov_len -= rest;
+            }
+        }
+        return {};
+    }
+
+#endif
+
+}  // namespace runtime
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace runtime {
+
+    // ,           
+    //  .     ,    
+    // ,        writev. flush  
+    //    ,   .
+    //     Flush   
+    class AsyncOutputContext : public Context {
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+        static constexpr size_t BUFFER_COUNT = 4;
+
+        //  fd   
+        explicit AsyncOutputContext(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+        //   .      
+        ~AsyncOutputContext();
+
+        AsyncOutputContext(const AsyncOutputContext&) = delete;
+        AsyncOutputContext& operator=(const AsyncOutputContext&) = delete;
+
+        std::ostream& GetOutputStream() override {
+            return stream_;
+        }
+
+        //    .    , 
+        // runtime_error;     
+        void Flush();
+
+    private:
+        class Buffer : public std::streambuf {
+        public:
+            explicit Buffer(AsyncOutputContext& owner)
+                : owner_(owner) {
+            }
+
+            //       
+            void Submit();
+            //     [begin, end)
+            void Reset(char* begin, char* end);
+
+        protected:
+            int_type overflow(int_type ch) override;
+            std::streamsize xsputn(const char* s, std::streamsize count) override;
+            int sync() override;
+
+        private:
+            AsyncOutputContext& owner_;
+        };
+
+        struct Chunk {
+            size_t index;
+            size_t size;
+        };
+
+        //    chunk    ,    
+        char* Exchange(Chunk chunk);
+        void RunWriter();
+        //  chunks     writev.   
+        std::string Write(const std::vector<Chunk>& chunks);
+
+        int fd_;
+        size_t buffer_size_;
+        std::vector<std::vector<char>> buffers_;
+        // ,    
+        size_t current_ = 0;
+
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable buffer_free_;
+        std::deque<Chunk> full_;
+        std::vector<size_t> free_;
+        // ,    
+        size_t writing_ = 0;
+        bool stopping_ = false;
+        std::string error_;
+
+        Buffer buffer_;
+        std::ostream stream_;
+        std::thread writer_;
+    };
+
+}  // namespace runtime
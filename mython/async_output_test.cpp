@@ -0,0 +1,87 @@
+#include "async_output.h"
+#include "lexer.h"
+#include "parse.h"
+#include "test_runner_p.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+
+        void TestAsyncOutput() {
+            const string program = R"(
+class Printer:
+  def run(n):
+    if n > 0:
+      print "line", n
+      self.run(n - 1)
+
+p = Printer()
+p.run(500)
+)"s;
+            string expected;
+            for (int i = 500; i > 0; --i) {
+                expected += "line "s + to_string(i) + "\n"s;
+            }
+
+            //  :       
+            FILE* file = tmpfile();
+            ASSERT(file != nullptr);
+            {
+                runtime::AsyncOutputContext context{ fileno(file), 64 };
+                istringstream input(program);
+                parse::Lexer lexer(input);
+                auto tree = ParseProgram(lexer);
+                runtime::Closure closure;
+                tree->Execute(closure, context);
+                context.Flush();
+                //   Flush    
+                context.GetOutputStream() << "end\n"sv;
+            }
+            rewind(file);
+            string written;
+            char chunk[4096];
+            for (size_t size; (size = fread(chunk, 1, sizeof(chunk), file)) > 0;) {
+                written.append(chunk, size);
+            }
+            fclose(file);
+            ASSERT_EQUAL(written, expected + "end\n"s);
+
+            // flush     ,    
+            int pipe_fds[2];
+            ASSERT_EQUAL(pipe(pipe_fds), 0);
+            {
+                runtime::AsyncOutputContext context{ pipe_fds[1] };
+                context.GetOutputStream() << "ready\n"sv << flush;
+                char received[6];
+                size_t done = 0;
+                while (done < sizeof(received)) {
+                    const ssize_t count = read(pipe_fds[0], received + done, sizeof(received) - done);
+                    ASSERT(count > 0);
+                    done += static_cast<size_t>(count);
+                }
+                ASSERT_EQUAL(string(received, sizeof(received)), "ready\n"s);
+            }
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+
+            //     Flush
+            runtime::AsyncOutputContext broken{ -1 };
+            broken.GetOutputStream() << "lost\n"sv;
+            ASSERT_THROWS(broken.Flush(), runtime_error);
+        }
+
+    }  // namespace
+
+    void RunAsyncOutputTests(TestRunner& tr) {
+        RUN_TEST(tr, runtime::TestAsyncOutput);
+    }
+
+}  // namespace runtime
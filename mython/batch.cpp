@@ -0,0 +1,147 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+namespace mython {
+
+    namespace {
+        //    .     ,  -  
+        class JobQueue {
+        public:
+            void Push(size_t job) {
+                jobs_.push_back(job);
+            }
+
+            bool PopFront(size_t& job) {
+                lock_guard lock(mutex_);
+                if (jobs_.empty()) {
+                    return false;
+                }
+                job = jobs_.front();
+                jobs_.pop_front();
+                return true;
+            }
+
+            bool PopBack(size_t& job) {
+                lock_guard lock(mutex_);
+                if (jobs_.empty()) {
+                    return false;
+                }
+                job = jobs_.back();
+                jobs_.pop_back();
+                return true;
+            }
+
+        private:
+            mutex mutex_;
+            deque<size_t> jobs_;
+        };
+
+        //   ,     
+        class Worker {
+        public:
+            void Run(BatchJob& job, BatchJobResult& result) {
+                const auto start = chrono::steady_clock::now();
+                output_.str({});
+                output_.clear();
+                try {
+                    mython::Run(GetProgram(job.script), context_, std::move(job.inputs));
+                }
+                catch (const exception& e) {
+                    result.ok = false;
+                    result.error = e.what();
+                }
+                if (job.output) {
+                    *job.output << output_.str();
+                }
+                else {
+                    result.output = output_.str();
+                }
+                result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            }
+
+        private:
+            const CompiledProgram& GetProgram(string_view script) {
+                if (const auto it = programs_.find(script); it != programs_.end()) {
+                    return it->second;
+                }
+                return programs_.emplace(script, Compile(script)).first->second;
+            }
+
+            ostringstream output_;
+            runtime::SimpleContext context_{ output_ };
+            unordered_map<string_view, CompiledProgram> programs_;
+        };
+    }  // namespace
+
+    BatchReport RunBatch(std::vector<BatchJob> jobs, size_t thread_count) {
+        const auto start = chrono::steady_clock::now();
+        if (thread_count == 0) {
+            thread_count = max<size_t>(thread::hardware_concurrency(), 1);
+        }
+        thread_count = max<size_t>(min(thread_count, jobs.size()), 1);
+
+        //      ,       
+        vector<JobQueue> queues(thread_count);
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            queues[i * thread_count / jobs.size()].Push(i);
+        }
+
+        BatchReport report;
+        report.jobs.resize(jobs.size());
+        atomic<size_t> steal_count{ 0 };
+        auto work = [&](size_t index) {
+            Worker worker;
+            size_t job;
+            while (true) {
+                if (!queues[index].PopFront(job)) {
+                    //    ,   ,    
+                    bool stolen = false;
+                    for (size_t i = 1; i < thread_count && !stolen; ++i) {
+                        stolen = queues[(index + i) % thread_count].PopBack(job);
+                    }
+                    if (!stolen) {
+                        return;
+                    }
+                    steal_count.fetch_add(1, memory_order_relaxed);
+                }
+                worker.Run(jobs[job], report.jobs[job]);
+            }
+        };
+
+        vector<thread> threads;
+        for (size_t i = 1; i < thread_count; ++i) {
+            try {
+                threads.emplace_back(work, i);
+            }
+            catch (const system_error&) {
+                //  ,    ,  
+                break;
+            }
+        }
+        work(0);
+        for (thread& worker : threads) {
+            worker.join();
+        }
+
+        for (const BatchJobResult& result : report.jobs) {
+            report.error_count += result.ok ? 0 : 1;
+        }
+        report.steal_count = steal_count;
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+}  // namespace mython
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "mython.h"
+#include "runtime.h"
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mython {
+
+    //   
+    struct BatchJob {
+        //  .     RunBatch.  
+        //        
+        std::string_view script;
+        //  ,    
+        runtime::Closure inputs;
+        // ,        .  
+        //   ,        
+        // .  nullptr,    BatchJobResult::output
+        std::ostream* output = nullptr;
+    };
+
+    struct BatchJobResult {
+        bool ok = true;
+        //       
+        std::string error;
+        std::string output;
+        //   ,   ,     
+        //  
+        double seconds = 0;
+    };
+
+    struct BatchReport {
+        //    
+        std::vector<BatchJobResult> jobs;
+        size_t error_count = 0;
+        //  ,       
+        size_t steal_count = 0;
+        double seconds = 0;
+
+        [[nodiscard]] double GetJobsPerSecond() const {
+            return seconds > 0 ? static_cast<double>(jobs.size()) / seconds : 0;
+        }
+    };
+
+    //    thread_count  (0 -    ). 
+    //     ,  ,   , 
+    //    .        
+    //   .      
+    BatchReport RunBatch(std::vector<BatchJob> jobs, size_t thread_count = 0);
+
+}  // namespace mython
@@ -0,0 +1,59 @@
+#include "batch.h"
+#include "test_runner_p.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace mython {
+
+    namespace {
+
+        void TestBatch() {
+            const string square = "print n * n\n"s;
+            const string greet = R"(
+class Greeter:
+  def greet(name):
+    return "Hello, " + name
+
+g = Greeter()
+print g.greet(name)
+)"s;
+            const string broken = "print (\n"s;
+
+            vector<mython::BatchJob> jobs;
+            for (int i = 0; i < 100; ++i) {
+                jobs.push_back({ square, { { "n"s, runtime::ObjectHolder::Own(runtime::Number(i)) } } });
+            }
+            jobs.push_back({ greet, { { "name"s, runtime::ObjectHolder::Own(runtime::String("batch"s)) } } });
+            jobs.push_back({ broken, {} });
+            //  n  
+            jobs.push_back({ square, {} });
+            ostringstream sink;
+            jobs.push_back({ greet, { { "name"s, runtime::ObjectHolder::Own(runtime::String("sink"s)) } }, &sink });
+
+            const mython::BatchReport report = mython::RunBatch(std::move(jobs), 3);
+            ASSERT_EQUAL(report.jobs.size(), 104u);
+            ASSERT_EQUAL(report.error_count, 2u);
+            for (int i = 0; i < 100; ++i) {
+                ASSERT(report.jobs[i].ok);
+                ASSERT_EQUAL(report.jobs[i].output, to_string(i * i) + "\n"s);
+            }
+            ASSERT_EQUAL(report.jobs[100].output, "Hello, batch\n"s);
+            ASSERT(!report.jobs[101].ok);
+            ASSERT(!report.jobs[102].ok);
+            ASSERT(report.jobs[103].ok);
+            ASSERT(report.jobs[103].output.empty());
+            ASSERT_EQUAL(sink.str(), "Hello, sink\n"s);
+            ASSERT(report.GetJobsPerSecond() > 0);
+        }
+
+    }  // namespace
+
+    void RunBatchTests(TestRunner& tr) {
+        RUN_TEST(tr, mython::TestBatch);
+    }
+
+}  // namespace mython
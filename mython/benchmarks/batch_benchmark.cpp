@@ -0,0 +1,84 @@
+#include "../batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//          , 
+//      .   :  
+//    . :
+// g++ -O2 -std=c++17 -pthread batch_benchmark.cpp ../execution_budget.cpp ../batch.cpp ../mython.cpp ../tasks.cpp
+// ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int JOB_COUNT = 20000;
+
+    const string SCRIPT = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Formatter:
+  def format(name, value):
+    return name + " = " + str(value)
+
+fib = Fib()
+f = Formatter()
+print f.format("fib", fib.calc(n))
+)"s;
+
+    vector<mython::BatchJob> MakeJobs() {
+        vector<mython::BatchJob> jobs;
+        jobs.reserve(JOB_COUNT);
+        for (int i = 0; i < JOB_COUNT; ++i) {
+            const int n = i % 100 == 0 ? 14 : 5;
+            jobs.push_back({ SCRIPT, { { "n"s, runtime::ObjectHolder::Own(runtime::Number(n)) } } });
+        }
+        return jobs;
+    }
+
+    void PrintLatencies(vector<double> latencies) {
+        sort(latencies.begin(), latencies.end());
+        cout << ", job p50 "sv << latencies[latencies.size() / 2] * 1e6 << " us, p99 "sv
+             << latencies[latencies.size() * 99 / 100] * 1e6 << " us"sv << endl;
+    }
+}  // namespace
+
+int main() {
+    {
+        vector<mython::BatchJob> jobs = MakeJobs();
+        vector<double> latencies;
+        const auto start = chrono::steady_clock::now();
+        for (mython::BatchJob& job : jobs) {
+            const auto job_start = chrono::steady_clock::now();
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            mython::Run(mython::Compile(job.script), context, std::move(job.inputs));
+            latencies.push_back(chrono::duration<double>(chrono::steady_clock::now() - job_start).count());
+        }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "one by one:         "sv << JOB_COUNT / seconds << " jobs/s"sv;
+        PrintLatencies(std::move(latencies));
+    }
+
+    const size_t max_threads = max<size_t>(thread::hardware_concurrency(), 4);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        const mython::BatchReport report = mython::RunBatch(MakeJobs(), threads);
+        vector<double> latencies;
+        for (const mython::BatchJobResult& job : report.jobs) {
+            latencies.push_back(job.seconds);
+        }
+        cout << "batch, "sv << threads << " threads:   "sv << report.GetJobsPerSecond() << " jobs/s, "sv
+             << report.steal_count << " stolen"sv;
+        PrintLatencies(std::move(latencies));
+    }
+}
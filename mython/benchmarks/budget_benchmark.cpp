@@ -0,0 +1,71 @@
+#include "../execution_budget.h"
+#include "../mython.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//       :  ,   
+// ,        SuspendableRun.  
+//       . :
+// g++ -O2 -std=c++17 -pthread budget_benchmark.cpp ../execution_budget.cpp ../mython.cpp ../tasks.cpp
+// ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int REPEAT_COUNT = 5;
+
+    const string SCRIPT = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+f = Fib()
+print f.calc(24)
+)"s;
+
+    template <typename Action>
+    void Report(string_view name, Action action) {
+        double best = 0;
+        for (int i = 0; i < REPEAT_COUNT; ++i) {
+            const auto start = chrono::steady_clock::now();
+            action();
+            const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            best = i == 0 ? ms : min(best, ms);
+        }
+        cout << name << best << " ms"sv << endl;
+    }
+}  // namespace
+
+int main() {
+    const mython::CompiledProgram program = mython::Compile(SCRIPT);
+    ostringstream output;
+    runtime::SimpleContext context{ output };
+
+    Report("no budget:            "sv, [&] {
+        mython::Run(program, context);
+    });
+    Report("unlimited budget:     "sv, [&] {
+        runtime::ExecutionBudget budget(0);
+        context.SetExecutionBudget(&budget);
+        mython::Run(program, context);
+        context.SetExecutionBudget(nullptr);
+    });
+    Report("limit 10^9 steps:     "sv, [&] {
+        runtime::ExecutionBudget budget(1'000'000'000);
+        context.SetExecutionBudget(&budget);
+        mython::Run(program, context);
+        context.SetExecutionBudget(nullptr);
+    });
+    Report("slices of 10^4 steps: "sv, [&] {
+        mython::SuspendableRun run(program, context, 10'000);
+        while (run.RunSlice() == mython::SuspendableRun::State::Suspended) {
+        }
+    });
+}
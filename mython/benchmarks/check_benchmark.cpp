@@ -0,0 +1,56 @@
+#include "../parse_check.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//            
+// . :
+// g++ -O2 -std=c++17 check_benchmark.cpp ../execution_budget.cpp ../parse_check.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp -lpthread
+
+namespace {
+    constexpr int FILE_COUNT = 2000;
+
+    //   200 .       
+    string MakeScript(int index) {
+        string text;
+        for (int c = 0; c < 10; ++c) {
+            text += "class C"s + to_string(c) + ":\n"s
+                + "  def __init__(x):\n    self.x = x\n\n"s
+                + "  def calc(a, b):\n    if a < b and not b == 0:\n      return self.calc(b, a)\n"s
+                + "    result = a * 2 + b * 3 - (a - b) / 2\n    return str(result) + 'text'\n\n"s;
+        }
+        for (int i = 0; i < 50; ++i) {
+            text += "x"s + to_string(i) + " = C"s + to_string(i % 10) + "("s + to_string(i) + ")\n"s;
+        }
+        if (index % 10 == 0) {
+            text += "if x0\n"s;
+        }
+        return text;
+    }
+}  // namespace
+
+int main() {
+    const auto dir = filesystem::temp_directory_path() / "mython_check_benchmark"s;
+    filesystem::create_directories(dir);
+    vector<string> paths;
+    for (int i = 0; i < FILE_COUNT; ++i) {
+        paths.push_back((dir / ("script"s + to_string(i) + ".my"s)).string());
+        ofstream(paths.back()) << MakeScript(i);
+    }
+
+    for (const size_t threads : { size_t{ 1 }, size_t{ 2 }, size_t{ 4 }, size_t{ thread::hardware_concurrency() } }) {
+        const parse::CheckReport report = parse::CheckFiles(paths, threads);
+        cout << threads << " threads: "sv << report.seconds * 1000 << " ms, "sv
+             << static_cast<double>(report.files.size()) / report.seconds << " files/s, "sv
+             << report.error_count << " with errors"sv << endl;
+    }
+    filesystem::remove_all(dir);
+}
@@ -0,0 +1,70 @@
+#include "../lexer.h"
+#include "../mython.h"
+#include "../parse.h"
+#include "../runtime.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//    ,      
+// ,   RunMythonProgram,        .
+// :
+// g++ -O2 -std=c++17 -pthread embed_benchmark.cpp ../execution_budget.cpp ../mython.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int REQUEST_COUNT = 2000;
+    constexpr int HELPER_COUNT = 30;
+
+    //  :          n
+    string MakeHandler() {
+        string text;
+        for (int i = 0; i < HELPER_COUNT; ++i) {
+            text += "class Helper"s + to_string(i) + ":\n"s
+                + "  def apply(x):\n    if x < 0:\n      return 0 - x\n    return x * 2 + "s + to_string(i) + "\n\n"s
+                + "  def describe(x):\n    return 'helper "s + to_string(i) + ": ' + str(self.apply(x))\n\n"s;
+        }
+        text += "class Handler:\n  def handle(n):\n    h = Helper7()\n    return h.describe(n)\n\n"s
+            + "handler = Handler()\nresponse = handler.handle(n)\n"s;
+        return text;
+    }
+
+    template <typename Request>
+    void Report(string_view name, Request request) {
+        vector<double> latencies;
+        latencies.reserve(REQUEST_COUNT);
+        for (int i = 0; i < REQUEST_COUNT; ++i) {
+            const auto start = chrono::steady_clock::now();
+            request(i);
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        }
+        sort(latencies.begin(), latencies.end());
+        cout << name << "p50 "sv << latencies[latencies.size() / 2] << " us, p99 "sv
+             << latencies[latencies.size() * 99 / 100] << " us"sv << endl;
+    }
+}  // namespace
+
+int main() {
+    const string handler = MakeHandler();
+    runtime::DummyContext context;
+
+    Report("parse per request: "sv, [&](int i) {
+        istringstream input(handler);
+        parse::Lexer lexer(input, parse::Lexer::Mode::Streaming);
+        auto program = ParseProgram(lexer);
+        runtime::Closure closure{ { "n"s, runtime::ObjectHolder::Own(runtime::Number(i)) } };
+        program->Execute(closure, context);
+    });
+
+    const mython::CompiledProgram program = mython::Compile(handler);
+    Report("compiled program:  "sv, [&](int i) {
+        mython::Run(program, context, { { "n"s, runtime::ObjectHolder::Own(runtime::Number(i)) } });
+    });
+}
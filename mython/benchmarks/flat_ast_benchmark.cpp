@@ -0,0 +1,63 @@
+#include "../lexer.h"
+#include "../parse.h"
+#include "../runtime.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//       ast    flat_ast     
+// . :
+// g++ -O2 -std=c++17 -pthread flat_ast_benchmark.cpp ../execution_budget.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    const string PROGRAM = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Gcd:
+  def calc(a, b):
+    if a < b:
+      return self.calc(b, a)
+    if b == 0:
+      return a
+    return self.calc(a - b, b)
+
+fib = Fib()
+gcd = Gcd()
+x = fib.calc(20)
+y = gcd.calc(510510, 18629977) + gcd.calc(1000, 7) * 2
+ok = x > 0 and y > 0 and not x == y
+)"s;
+
+    constexpr int RUN_COUNT = 10;
+
+    double MeasureMs(unique_ptr<runtime::Executable> (*parse_program)(parse::Lexer&)) {
+        istringstream input(PROGRAM);
+        parse::Lexer lexer(input);
+        auto program = parse_program(lexer);
+
+        runtime::DummyContext context;
+        const auto start = chrono::steady_clock::now();
+        for (int i = 0; i < RUN_COUNT; ++i) {
+            runtime::Closure closure;
+            program->Execute(closure, context);
+        }
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+}  // namespace
+
+int main() {
+    const double tree_ms = MeasureMs(ParseProgram);
+    const double flat_ms = MeasureMs(ParseFlatProgram);
+    cout << "ast:: classes: "sv << tree_ms / RUN_COUNT << " ms per run"sv << endl;
+    cout << "flat_ast:      "sv << flat_ms / RUN_COUNT << " ms per run"sv << endl;
+}
@@ -0,0 +1,60 @@
+#include "../incremental_program.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//            
+//   . :
+// g++ -O2 -std=c++17 -pthread incremental_parse_benchmark.cpp ../execution_budget.cpp ../incremental_program.cpp
+// ../tasks.cpp ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp
+// ../flat_ast.cpp ../heap_profiler.cpp
+
+namespace {
+    constexpr int CLASS_COUNT = 2000;
+    constexpr int METHOD_COUNT = 5;
+
+    //  50  .  method0  edited_class  edited_value
+    string MakeLibrary(int edited_class, int edited_value) {
+        ostringstream out;
+        for (int c = 0; c < CLASS_COUNT; ++c) {
+            out << "class Lib"sv << c << ":\n"sv;
+            for (int m = 0; m < METHOD_COUNT; ++m) {
+                out << "  def method"sv << m << "(a, b):\n"sv
+                    << "    if a < b:\n"sv
+                    << "      return self.method"sv << m << "(b, a)\n"sv
+                    << "    result = a * 2 + b * 3 - (a - b) / 2\n"sv
+                    << "    return "sv << (c == edited_class && m == 0 ? edited_value : 0) << " + result\n"sv;
+            }
+        }
+        out << "lib = Lib"sv << CLASS_COUNT / 2 << "()\n"sv
+            << "x = lib.method0(1, 2)\n"sv;
+        return out.str();
+    }
+
+    template <typename Action>
+    double MeasureMs(Action action) {
+        const auto start = chrono::steady_clock::now();
+        action();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+}  // namespace
+
+int main() {
+    const string source = MakeLibrary(CLASS_COUNT / 2, 0);
+    const string edited = MakeLibrary(CLASS_COUNT / 2, 1);
+
+    unique_ptr<parse::IncrementalProgram> program;
+    const double full_ms = MeasureMs([&] {
+        program = make_unique<parse::IncrementalProgram>(source);
+    });
+    parse::IncrementalProgram::UpdateStats stats;
+    const double update_ms = MeasureMs([&] {
+        stats = program->Update(edited);
+    });
+    cout << "full parse:       "sv << full_ms << " ms"sv << endl;
+    cout << "one method edit:  "sv << update_ms << " ms ("sv << stats.methods << " method reparsed)"sv << endl;
+}
@@ -0,0 +1,69 @@
+#include "../mython.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ,       ,    
+//     . :
+// g++ -O2 -std=c++17 -pthread isolate_benchmark.cpp ../execution_budget.cpp ../mython.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    const string PROGRAM = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Text:
+  def repeat(s, n):
+    if n == 0:
+      return ""
+    return s + self.repeat(s, n - 1)
+
+fib = Fib()
+text = Text()
+x = fib.calc(15)
+y = text.repeat("ab", 20)
+)"s;
+
+    constexpr int RUNS_PER_THREAD = 200;
+
+    //        thread_count 
+    double MeasureRunsPerSecond(const mython::CompiledProgram& program, size_t thread_count) {
+        vector<thread> threads;
+        const auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads.emplace_back([&program] {
+                mython::Isolate isolate(program);
+                for (int run = 0; run < RUNS_PER_THREAD; ++run) {
+                    isolate.Run();
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return static_cast<double>(thread_count * RUNS_PER_THREAD) / seconds;
+    }
+}  // namespace
+
+int main() {
+    const mython::CompiledProgram program = mython::Compile(PROGRAM);
+    //         ,        
+    const size_t max_threads = max<size_t>(thread::hardware_concurrency(), 4);
+    const double base = MeasureRunsPerSecond(program, 1);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        const double runs = threads == 1 ? base : MeasureRunsPerSecond(program, threads);
+        cout << threads << " threads: "sv << runs << " runs/s, speedup "sv << runs / base << endl;
+    }
+}
@@ -0,0 +1,83 @@
+#include "../lane_eval.h"
+#include "../mython.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//             
+// LaneEvaluator. :
+// g++ -O3 -std=c++17 -pthread lane_benchmark.cpp ../execution_budget.cpp ../lane_eval.cpp ../mython.cpp ../tasks.cpp
+// ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int INPUT_COUNT = 200000;
+
+    const string PROGRAM = R"(
+class Scorer:
+  def __init__(bonus, limit):
+    self.bonus = bonus
+    self.limit = limit
+
+  def score(age, income, debt, member):
+    if age < 18:
+      return 0
+    score = income / 100 - debt / 50
+    if member and income > self.limit:
+      score = score + self.bonus
+    if debt > income:
+      score = score - (debt - income) / 20
+    else:
+      score = score + (income - debt) / 40
+    if age > 65:
+      score = score * 3 / 4
+    if score < 0:
+      return 0
+    return score
+
+scorer = Scorer(25, 3000)
+)"s;
+}  // namespace
+
+int main() {
+    const mython::CompiledProgram program = mython::Compile(PROGRAM);
+    ostringstream output;
+    runtime::SimpleContext context{ output };
+    const runtime::Closure globals = mython::Run(program, context);
+    const runtime::ObjectHolder scorer = globals.at("scorer"s);
+
+    vector<vector<runtime::ObjectHolder>> inputs;
+    inputs.reserve(INPUT_COUNT);
+    for (int i = 0; i < INPUT_COUNT; ++i) {
+        inputs.push_back({ runtime::ObjectHolder::Own(runtime::Number(10 + i * 7 % 80)),
+            runtime::ObjectHolder::Own(runtime::Number(i * 131 % 9000)),
+            runtime::ObjectHolder::Own(runtime::Number(i * 71 % 6000)),
+            runtime::ObjectHolder::Own(runtime::Bool(i % 4 == 0)) });
+    }
+
+    auto start = chrono::steady_clock::now();
+    long long scalar_sum = 0;
+    auto* instance = scorer.TryAs<runtime::ClassInstance>();
+    for (const auto& args : inputs) {
+        scalar_sum += instance->Call("score"s, args, context).TryAs<runtime::Number>()->GetValue();
+    }
+    const double scalar = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    flat_ast::LaneEvaluator evaluator(scorer, "score"s);
+    long long lane_sum = 0;
+    for (const runtime::ObjectHolder& result : evaluator.Evaluate(inputs, context)) {
+        lane_sum += result.TryAs<runtime::Number>()->GetValue();
+    }
+    const double lanes = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << INPUT_COUNT << " inputs, checksum "sv << (scalar_sum == lane_sum ? "ok"sv : "MISMATCH"sv) << endl;
+    cout << "scalar calls: "sv << scalar * 1000 << " ms"sv << endl;
+    cout << "lanes:        "sv << lanes * 1000 << " ms, speedup "sv << scalar / lanes
+         << " ("sv << evaluator.GetStats().vector_lanes << " inputs by lanes)"sv << endl;
+}
@@ -0,0 +1,64 @@
+#include "../lexer.h"
+#include "../parse.h"
+#include "../runtime.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//            
+//     .      .  
+//     . :
+// g++ -O2 -std=c++17 -pthread lazy_parse_benchmark.cpp ../execution_budget.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int CLASS_COUNT = 2000;
+    constexpr int METHOD_COUNT = 5;
+
+    //  50  : CLASS_COUNT   METHOD_COUNT 
+    string MakeLibrary() {
+        ostringstream out;
+        for (int c = 0; c < CLASS_COUNT; ++c) {
+            out << "class Lib"sv << c << ":\n"sv;
+            for (int m = 0; m < METHOD_COUNT; ++m) {
+                out << "  def method"sv << m << "(a, b):\n"sv
+                    << "    if a < b:\n"sv
+                    << "      return self.method"sv << m << "(b, a)\n"sv
+                    << "    result = a * 2 + b * 3 - (a - b) / 2\n"sv
+                    << "    return \"value: \" + str(result)\n"sv;
+            }
+        }
+        out << "lib = Lib"sv << CLASS_COUNT / 2 << "()\n"sv
+            << "x = lib.method0(1, 2)\n"sv;
+        return out.str();
+    }
+
+    template <typename Parse>
+    double MeasureMs(const string& source, Parse parse_program) {
+        istringstream input(source);
+        auto lexer = make_unique<parse::Lexer>(input);
+
+        const auto start = chrono::steady_clock::now();
+        auto program = parse_program(std::move(lexer));
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        program->Execute(closure, context);
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+}  // namespace
+
+int main() {
+    const string source = MakeLibrary();
+    const double eager_ms = MeasureMs(source, [](unique_ptr<parse::Lexer> lexer) {
+        return ParseProgram(*lexer);
+    });
+    const double lazy_ms = MeasureMs(source, ParseLazyProgram);
+    cout << "eager method bodies: "sv << eager_ms << " ms"sv << endl;
+    cout << "lazy method bodies:  "sv << lazy_ms << " ms"sv << endl;
+}
@@ -0,0 +1,116 @@
+#include "../lexer.h"
+#include "../lexer_scan.h"
+#include "../mapped_file.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//      /     
+//   ,         . :
+// g++ -O2 -std=c++17 -pthread lexer_benchmark.cpp ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp
+
+namespace {
+    const string CLASS_TEXT = R"(
+class Account_%:
+  def __init__(owner_name, initial_balance_value):
+    #     
+    self.owner_name = owner_name
+    self.balance_value = initial_balance_value
+    self.description = 'account of some customer with a rather long description text'
+
+  def deposit(amount_of_money):
+    if amount_of_money > 0 and not amount_of_money > 1000000000:
+      self.balance_value = self.balance_value + amount_of_money * 1 - 0
+    else:
+      print "refused deposit for", self.owner_name, "amount", amount_of_money
+
+  def __str__():
+    return str(self.owner_name) + ": " + str(self.balance_value)
+
+account = Account_%("customer number 123456", 1234567)
+account.deposit(987654)
+)"s;
+
+    //     ,      
+    const string LITERALS_TEXT = R"(
+text_% = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris"
+a_rather_long_identifier_name_that_describes_the_value_in_great_detail_% = 'another literal of a considerable length that the lexer has to scan to find its closing quote'
+)"s;
+
+    constexpr size_t PROGRAM_SIZE = 32 << 20;
+    constexpr int RUN_COUNT = 5;
+
+    string MakeProgram(const string& pattern) {
+        string program;
+        for (int i = 0; program.size() < PROGRAM_SIZE; ++i) {
+            string text = pattern;
+            for (size_t pos = text.find('%'); pos != string::npos; pos = text.find('%', pos)) {
+                text.replace(pos, 1, to_string(i));
+            }
+            program += text;
+        }
+        return program;
+    }
+
+    template <typename MakeLexer>
+    double MeasureMbPerSecond(size_t size, MakeLexer make_lexer) {
+        double best_seconds = 0;
+        for (int i = 0; i < RUN_COUNT; ++i) {
+            const auto start = chrono::steady_clock::now();
+            parse::Lexer lexer = make_lexer();
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (i == 0 || seconds < best_seconds) {
+                best_seconds = seconds;
+            }
+        }
+        return static_cast<double>(size) / (1 << 20) / best_seconds;
+    }
+
+    void Measure(string_view name, const string& program) {
+        const string path = (filesystem::temp_directory_path() / "mython_lexer_benchmark.my"s).string();
+        ofstream(path, ios::binary) << program;
+        const auto file = make_shared<const parse::MappedFile>(path);
+        remove(path.c_str());
+
+        cout << name << ", "sv << program.size() / (1 << 20) << " MB"sv << endl;
+        for (const auto isa : { parse::scan::Isa::Scalar, parse::scan::Isa::Sse2, parse::scan::Isa::Avx2 }) {
+            if (!parse::scan::SetIsa(isa)) {
+                continue;
+            }
+            cout << "  mapped file, "sv << parse::scan::GetIsaName(isa) << ": "sv
+                 << MeasureMbPerSecond(program.size(), [&file] {
+                        return parse::Lexer(file);
+                    })
+                 << " MB/s"sv << endl;
+        }
+
+        parse::scan::SetIsa(parse::scan::DetectIsa());
+        cout << "  istream, "sv << parse::scan::GetIsaName(parse::scan::GetIsa()) << ": "sv
+             << MeasureMbPerSecond(program.size(), [&program] {
+                    istringstream input(program);
+                    return parse::Lexer(input);
+                })
+             << " MB/s"sv << endl;
+
+        for (const size_t thread_count : { 2, 4, 8 }) {
+            cout << "  mapped file, "sv << thread_count << " threads: "sv
+                 << MeasureMbPerSecond(program.size(), [&file, thread_count] {
+                        return parse::Lexer(file, parse::Lexer::ParallelOptions{ thread_count });
+                    })
+                 << " MB/s"sv << endl;
+        }
+    }
+}  // namespace
+
+int main() {
+    Measure("classes"sv, MakeProgram(CLASS_TEXT));
+    Measure("long literals"sv, MakeProgram(LITERALS_TEXT));
+}
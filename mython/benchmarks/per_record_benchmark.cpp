@@ -0,0 +1,82 @@
+#include "../mython.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//      RunPerRecord     
+//    . :
+// g++ -O2 -std=c++17 -pthread per_record_benchmark.cpp ../execution_budget.cpp ../mython.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+
+namespace {
+    constexpr int LINE_COUNT = 100000;
+    constexpr int CLASS_COUNT = 20;
+
+    //      ,    
+    string MakeProgram() {
+        ostringstream out;
+        for (int c = 0; c < CLASS_COUNT; ++c) {
+            out << "class Helper"sv << c << ":\n"sv
+                << "  def apply(s):\n"sv
+                << "    return s + \""sv << c << "\"\n"sv;
+        }
+        out << R"(
+class Handler:
+  def __init__():
+    self.helper = Helper0()
+
+  def handle(line):
+    return self.helper.apply(line)
+
+handler = Handler()
+)"sv;
+        return out.str();
+    }
+
+    string MakeInput() {
+        ostringstream out;
+        for (int i = 0; i < LINE_COUNT; ++i) {
+            out << "record "sv << i << '\n';
+        }
+        return out.str();
+    }
+}  // namespace
+
+int main() {
+    const string program_text = MakeProgram();
+    const string input_text = MakeInput();
+
+    auto start = chrono::steady_clock::now();
+    {
+        const mython::CompiledProgram program = mython::Compile(program_text);
+        istringstream input(input_text);
+        ostringstream output;
+        runtime::SimpleContext context{ output };
+        mython::RunPerRecord(program, context, "handler.handle"sv, input);
+    }
+    const double per_record = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    //     ,      
+    start = chrono::steady_clock::now();
+    {
+        const string script = program_text + "print handler.handle(line)\n"s;
+        istringstream input(input_text);
+        ostringstream output;
+        runtime::SimpleContext context{ output };
+        for (string line; getline(input, line);) {
+            const mython::CompiledProgram program = mython::Compile(script);
+            mython::Run(program, context, { { "line"s, runtime::ObjectHolder::Own(runtime::String(line)) } });
+        }
+    }
+    const double per_line_parse = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << LINE_COUNT << " lines"sv << endl;
+    cout << "RunPerRecord:           "sv << LINE_COUNT / per_record << " lines/s"sv << endl;
+    cout << "parse and run per line: "sv << LINE_COUNT / per_line_parse << " lines/s, "sv
+         << per_line_parse / per_record << "x slower"sv << endl;
+}
@@ -0,0 +1,84 @@
+#include "../async_output.h"
+#include "../lexer.h"
+#include "../parse.h"
+#include "../runtime.h"
+#include "../tasks.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+//   ,    ,  SimpleContext  cout,
+//  AsyncOutputContext    TaskScheduler  AsyncOutputContext,  
+// .     stdout,    stderr. :
+// g++ -O2 -std=c++17 -pthread print_benchmark.cpp ../execution_budget.cpp ../async_output.cpp ../tasks.cpp ../lexer.cpp
+// ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp
+// ../heap_profiler.cpp
+// : ./a.out > /tmp/print_benchmark.txt
+
+namespace {
+    const string PROGRAM = R"(
+class Printer:
+  def row(i, j, n):
+    if n > 0:
+      print "row", i, j, "column", n, True
+      self.row(i, j, n - 1)
+
+  def rows(i, j):
+    if j > 0:
+      self.row(i, j, 100)
+      self.rows(i, j - 1)
+
+  def blocks(i):
+    if i > 0:
+      self.rows(i, 100)
+      self.blocks(i - 1)
+
+p = Printer()
+p.blocks(100)
+)"s;
+
+    //      
+    double Measure(runtime::Context& context) {
+        istringstream input(PROGRAM);
+        parse::Lexer lexer(input);
+        auto program = ParseFlatProgram(lexer);
+        const auto start = chrono::steady_clock::now();
+        runtime::Closure closure;
+        program->Execute(closure, context);
+        context.GetOutputStream().flush();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}  // namespace
+
+int main() {
+    runtime::SimpleContext simple{ cout };
+    const double simple_time = Measure(simple);
+
+    double async_time = 0;
+    {
+        runtime::AsyncOutputContext async{ fileno(stdout) };
+        async_time = Measure(async);
+        const auto start = chrono::steady_clock::now();
+        async.Flush();
+        async_time += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    double scheduler_time = 0;
+    {
+        runtime::AsyncOutputContext async{ fileno(stdout) };
+        runtime::TaskScheduler scheduler{ async.GetOutputStream() };
+        scheduler_time = Measure(scheduler.GetContext());
+        const auto start = chrono::steady_clock::now();
+        scheduler.Wait();
+        async.Flush();
+        scheduler_time += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    cerr << "SimpleContext(cout):  "sv << simple_time * 1000 << " ms"sv << endl;
+    cerr << "AsyncOutputContext:   "sv << async_time * 1000 << " ms, speedup "sv << simple_time / async_time << endl;
+    cerr << "TaskScheduler(async): "sv << scheduler_time * 1000 << " ms, speedup "sv << simple_time / scheduler_time << endl;
+}
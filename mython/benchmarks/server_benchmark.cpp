@@ -0,0 +1,105 @@
+#include "../server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+//      (  99- ):     
+//           .    
+// ,         . :
+// g++ -O2 -std=c++17 -pthread server_benchmark.cpp ../execution_budget.cpp ../server.cpp ../server_client.cpp
+// ../mython.cpp ../tasks.cpp ../lexer.cpp ../lexer_scan.cpp ../mapped_file.cpp ../parse.cpp ../runtime.cpp
+// ../statement.cpp ../flat_ast.cpp ../heap_profiler.cpp ../program_cache.cpp
+// : ./a.out [  Mython]
+
+extern char** environ;
+
+namespace {
+    constexpr int REQUEST_COUNT = 2000;
+    constexpr int PROCESS_COUNT = 100;
+
+    const string SCRIPT = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Greeter:
+  def greet(name):
+    return "Hello, " + name
+
+f = Fib()
+g = Greeter()
+print g.greet(stdin), f.calc(10)
+)"s;
+
+    template <typename Action>
+    void Report(string_view name, int count, Action action) {
+        vector<double> latencies;
+        latencies.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            const auto start = chrono::steady_clock::now();
+            action();
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        }
+        sort(latencies.begin(), latencies.end());
+        cout << name << "p50 "sv << latencies[latencies.size() / 2] << " us, p99 "sv
+             << latencies[latencies.size() * 99 / 100] << " us"sv << endl;
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto dir = filesystem::temp_directory_path() / "mython_server_benchmark"s;
+    filesystem::create_directories(dir);
+    const string socket_path = (dir / "server.sock"s).string();
+
+    mython::Server server({ socket_path, 0 });
+    thread acceptor([&server] {
+        server.Run();
+    });
+    {
+        mython::ServerClient client(socket_path);
+        const uint64_t id = client.Execute({ SCRIPT, 0, "world"s }).program_id;
+        Report("script, one connection:   "sv, REQUEST_COUNT, [&] {
+            client.Execute({ SCRIPT, 0, "world"s });
+        });
+        Report("id, one connection:       "sv, REQUEST_COUNT, [&] {
+            client.Execute({ {}, id, "world"s });
+        });
+        Report("id, connection per call:  "sv, REQUEST_COUNT, [&] {
+            mython::ServerClient(socket_path).Execute({ {}, id, "world"s });
+        });
+    }
+    server.Stop();
+    acceptor.join();
+
+    if (argc > 1) {
+        const string script_path = (dir / "script.my"s).string();
+        ofstream(script_path) << "stdin = \"world\"\n"sv << SCRIPT;
+        Report("process per script:       "sv, PROCESS_COUNT, [&] {
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+            char* const args[] = { argv[1], const_cast<char*>(script_path.c_str()), nullptr };
+            pid_t pid;
+            if (posix_spawn(&pid, argv[1], &actions, nullptr, args, environ) == 0) {
+                waitpid(pid, nullptr, 0);
+            }
+            posix_spawn_file_actions_destroy(&actions);
+        });
+    }
+    filesystem::remove_all(dir);
+}
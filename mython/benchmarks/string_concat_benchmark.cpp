@@ -0,0 +1,66 @@
+#include "../runtime.h"
+#include "../statement.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+//    : s = s + piece,  PIECE_COUNT .
+// : g++ -O2 -std=c++17 -pthread string_concat_benchmark.cpp ../execution_budget.cpp ../tasks.cpp ../runtime.cpp
+// ../statement.cpp ../heap_profiler.cpp
+
+namespace {
+    constexpr int PIECE_COUNT = 100000;
+    const string PIECE = "report line\n"s;
+
+    template <typename Fn>
+    double MeasureMs(Fn fn) {
+        const auto start = chrono::steady_clock::now();
+        fn();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    //   ast::Add,    
+    size_t ConcatWithAst() {
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        closure["s"s] = runtime::ObjectHolder::Own(runtime::String(""s));
+        closure["piece"s] = runtime::ObjectHolder::Own(runtime::String(PIECE));
+
+        ast::Assignment step("s"s, make_unique<ast::Add>(make_unique<ast::VariableValue>("s"s),
+            make_unique<ast::VariableValue>("piece"s)));
+        for (int i = 0; i < PIECE_COUNT; ++i) {
+            step.Execute(closure, context);
+        }
+        //     rope
+        return closure.at("s"s).TryAs<runtime::String>()->GetValue().size();
+    }
+
+    //  :        
+    size_t ConcatEagerly() {
+        runtime::String s(""s);
+        const runtime::String piece(PIECE);
+        for (int i = 0; i < PIECE_COUNT; ++i) {
+            string next;
+            next.reserve(s.GetSize() + piece.GetSize());
+            next.append(s.GetValue()).append(piece.GetValue());
+            s = runtime::String(std::move(next));
+        }
+        return s.GetSize();
+    }
+}  // namespace
+
+int main() {
+    size_t size = 0;
+    const double rope_ms = MeasureMs([&size] {
+        size = ConcatWithAst();
+    });
+    cout << "ast::Add, "sv << PIECE_COUNT << " pieces: "sv << rope_ms << " ms ("sv << size << " bytes)"sv << endl;
+
+    const double eager_ms = MeasureMs([&size] {
+        size = ConcatEagerly();
+    });
+    cout << "eager copy, "sv << PIECE_COUNT << " pieces: "sv << eager_ms << " ms ("sv << size << " bytes)"sv << endl;
+}
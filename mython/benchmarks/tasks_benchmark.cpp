@@ -0,0 +1,127 @@
+#include "../lexer.h"
+#include "../parse.h"
+#include "../tasks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+//           
+// spawn,         . :
+// g++ -O2 -std=c++17 -pthread tasks_benchmark.cpp ../execution_budget.cpp ../tasks.cpp ../lexer.cpp ../lexer_scan.cpp
+// ../mapped_file.cpp ../parse.cpp ../runtime.cpp ../statement.cpp ../flat_ast.cpp ../heap_profiler.cpp
+
+namespace {
+    constexpr int JOB_COUNT = 8;
+    constexpr int FIB_ARGUMENT = 20;
+    constexpr int MESSAGE_COUNT = 20000;
+
+    const string FIB_CLASS = R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+  def run(n, out):
+    out.send(self.calc(n))
+
+class Summer:
+  def sum(input, count, acc):
+    if count == 0:
+      return acc
+    return self.sum(input, count - 1, acc + input.receive())
+
+fib = Fib()
+summer = Summer()
+results = Channel(16)
+)"s;
+
+    string MakeSequential() {
+        ostringstream out;
+        out << FIB_CLASS << "total = 0\n"sv;
+        for (int i = 0; i < JOB_COUNT; ++i) {
+            out << "total = total + fib.calc("sv << FIB_ARGUMENT << ")\n"sv;
+        }
+        out << "print total\n"sv;
+        return out.str();
+    }
+
+    string MakeSpawned() {
+        ostringstream out;
+        out << FIB_CLASS;
+        for (int i = 0; i < JOB_COUNT; ++i) {
+            out << "spawn fib.run("sv << FIB_ARGUMENT << ", results)\n"sv;
+        }
+        out << "print summer.sum(results, "sv << JOB_COUNT << ", 0)\n"sv;
+        return out.str();
+    }
+
+    //      100,     
+    string MakePingPong() {
+        ostringstream out;
+        out << R"(
+class Sender:
+  def batch(out, i):
+    if i > 0:
+      out.send(i)
+      self.batch(out, i - 1)
+
+  def run(out, batches):
+    if batches > 0:
+      self.batch(out, 100)
+      self.run(out, batches - 1)
+
+class Receiver:
+  def batch(input, acc, i):
+    if i == 0:
+      return acc
+    return self.batch(input, acc + input.receive(), i - 1)
+
+  def run(input, acc, batches):
+    if batches == 0:
+      return acc
+    return self.run(input, self.batch(input, acc, 100), batches - 1)
+
+channel = Channel(64)
+sender = Sender()
+receiver = Receiver()
+)"sv;
+        out << "spawn sender.run(channel, "sv << MESSAGE_COUNT / 100 << ")\n"sv
+            << "print receiver.run(channel, 0, "sv << MESSAGE_COUNT / 100 << ")\n"sv;
+        return out.str();
+    }
+
+    //      
+    double Measure(const string& source, size_t thread_count) {
+        istringstream input(source);
+        parse::Lexer lexer(input);
+        auto program = ParseFlatProgram(lexer);
+        ostringstream output;
+        const auto start = chrono::steady_clock::now();
+        {
+            runtime::TaskScheduler scheduler{ output, thread_count };
+            runtime::Closure closure;
+            program->Execute(closure, scheduler.GetContext());
+            scheduler.Wait();
+        }
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}  // namespace
+
+int main() {
+    const size_t threads = max(1u, thread::hardware_concurrency());
+    const double sequential = Measure(MakeSequential(), threads);
+    const double spawned = Measure(MakeSpawned(), threads);
+    cout << JOB_COUNT << " x fib("sv << FIB_ARGUMENT << "), "sv << threads << " threads"sv << endl;
+    cout << "main program: "sv << sequential * 1000 << " ms"sv << endl;
+    cout << "spawn:        "sv << spawned * 1000 << " ms, speedup "sv << sequential / spawned << endl;
+
+    const double ping_pong = Measure(MakePingPong(), threads);
+    cout << "channel:      "sv << MESSAGE_COUNT / ping_pong << " messages/s"sv << endl;
+}
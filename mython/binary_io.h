@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+//      :     .
+//      ,     
+//     
+namespace binary_io {
+
+    //  ,        
+    inline constexpr size_t ALIGNMENT = 8;
+
+    class Writer {
+    public:
+        void Append(const void* data, size_t size) {
+            data_.append(static_cast<const char*>(data), size);
+        }
+
+        void Write(uint32_t value) {
+            Append(&value, sizeof(value));
+        }
+
+        void WriteU64(uint64_t value) {
+            Append(&value, sizeof(value));
+        }
+
+        void Write(std::string_view text) {
+            Write(static_cast<uint32_t>(text.size()));
+            Append(text.data(), text.size());
+        }
+
+        //      ALIGNMENT    
+        uint64_t Align() {
+            data_.resize((data_.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+            return data_.size();
+        }
+
+        std::string& GetData() {
+            return data_;
+        }
+
+    private:
+        std::string data_;
+    };
+
+    //     .      
+    // std::runtime_error
+    class Reader {
+    public:
+        explicit Reader(std::string_view data)
+            : data_(data) {
+        }
+
+        uint32_t ReadU32() {
+            uint32_t value;
+            std::memcpy(&value, Take(sizeof(value)).data(), sizeof(value));
+            return value;
+        }
+
+        uint64_t ReadU64() {
+            uint64_t value;
+            std::memcpy(&value, Take(sizeof(value)).data(), sizeof(value));
+            return value;
+        }
+
+        std::string_view ReadText() {
+            return Take(ReadU32());
+        }
+
+        //   ,       item_size 
+        uint32_t ReadCount(size_t item_size) {
+            using namespace std::literals;
+            const uint32_t count = ReadU32();
+            if (count > data_.size() / item_size) {
+                throw std::runtime_error("Corrupted binary data"s);
+            }
+            return count;
+        }
+
+    private:
+        std::string_view Take(size_t size) {
+            using namespace std::literals;
+            if (size > data_.size()) {
+                throw std::runtime_error("Truncated binary data"s);
+            }
+            const std::string_view result = data_.substr(0, size);
+            data_.remove_prefix(size);
+            return result;
+        }
+
+        std::string_view data_;
+    };
+
+    //  data   path,   .    
+    //  ,   ,       
+    // .  std::runtime_error   
+    inline void WriteFileAtomically(const std::string& path, std::string_view data) {
+        using namespace std::literals;
+        std::error_code error;
+        if (const auto dir = std::filesystem::path(path).parent_path(); !dir.empty()) {
+            std::filesystem::create_directories(dir, error);
+        }
+        const std::string temp_path = path + ".tmp"s;
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out) {
+                throw std::runtime_error("Can't write file "s + temp_path);
+            }
+        }
+        std::filesystem::rename(temp_path, path, error);
+        if (error) {
+            std::filesystem::remove(temp_path, error);
+            throw std::runtime_error("Can't write file "s + path);
+        }
+    }
+
+}  // namespace binary_io
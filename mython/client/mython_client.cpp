@@ -0,0 +1,52 @@
+#include "../server.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+//   :   ,  
+// Mython --serve SOCKET,   .     
+//  stdin. :
+// g++ -O2 -std=c++17 mython_client.cpp ../server_client.cpp -o mython_client
+// : mython_client SOCKET script.my < input.txt
+//         mython_client SOCKET --id ID < input.txt
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && !(argc == 4 && argv[2] == "--id"sv)) {
+        cerr << "Usage: "sv << argv[0] << " SOCKET SCRIPT | SOCKET --id ID"sv << endl;
+        return 2;
+    }
+    try {
+        mython::ServerRequest request;
+        if (argc == 4) {
+            request.program_id = stoull(argv[3]);
+        }
+        else {
+            ifstream script(argv[2], ios::binary);
+            if (!script) {
+                throw runtime_error("Can't open file "s + argv[2]);
+            }
+            request.script.assign(istreambuf_iterator<char>(script), istreambuf_iterator<char>());
+        }
+        request.input.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+
+        mython::ServerClient client(argv[1]);
+        const mython::ServerResponse response = client.Execute(request);
+        cout << response.output << flush;
+        if (!response.ok) {
+            cerr << response.error << endl;
+            return 1;
+        }
+        //        
+        cerr << "program id: "sv << response.program_id << endl;
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "execution_budget.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+using namespace std;
+
+namespace runtime {
+
+    ExecutionBudget::ExecutionBudget(uint64_t limit, uint64_t slice)
+        : limit_(limit)
+        , slice_(slice) {
+        Restart();
+    }
+
+    void ExecutionBudget::Refill() {
+        used_ += period_;
+        if (limit_ != 0 && used_ > limit_) {
+            //     ,     
+            period_ = countdown_ = 1;
+            throw BudgetExceededError("Execution budget of "s + to_string(limit_) + " steps exceeded"s);
+        }
+        Restart();
+        if (slice_ != 0 && (used_ - 1) % slice_ == 0) {
+            OnSlice();
+        }
+    }
+
+    void ExecutionBudget::Restart() {
+        //    , used_ -   
+        uint64_t next = numeric_limits<uint64_t>::max();
+        if (limit_ != 0 && limit_ < next) {
+            next = limit_ + 1;
+        }
+        if (slice_ != 0) {
+            next = min(next, used_ / slice_ * slice_ + slice_ + 1);
+        }
+        period_ = countdown_ = next - used_;
+    }
+
+}  // namespace runtime
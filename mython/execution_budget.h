@@ -0,0 +1,77 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace runtime {
+
+    // ,         
+    class BudgetExceededError : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    //     .  -      ,
+    //      .   
+    // Context::GetExecutionBudget();     ,   .
+    //         :  spawn 
+    //   (. TaskScheduler::SetTaskStepLimit)
+    class ExecutionBudget {
+    public:
+        // limit -   , 0 -  .   slice  
+        // OnSlice, 0 -  
+        explicit ExecutionBudget(uint64_t limit, uint64_t slice = 0);
+        virtual ~ExecutionBudget() = default;
+
+        ExecutionBudget(const ExecutionBudget&) = delete;
+        ExecutionBudget& operator=(const ExecutionBudget&) = delete;
+
+        //  .     ,     
+        // OnSlice.    limit,  BudgetExceededError    
+        //    
+        void Charge() {
+            if (--countdown_ == 0) {
+                Refill();
+            }
+        }
+
+        //   
+        [[nodiscard]] uint64_t GetUsed() const {
+            return used_ + (period_ - countdown_);
+        }
+
+        [[nodiscard]] uint64_t GetLimit() const {
+            return limit_;
+        }
+
+    protected:
+        //   ,    slice .   
+        //    ,   
+        virtual void OnSlice() {
+        }
+
+    private:
+        //   ,    countdown_
+        void Refill();
+        //     ,     OnSlice   
+        void Restart();
+
+        uint64_t limit_;
+        uint64_t slice_;
+        //     
+        uint64_t used_ = 0;
+        //        
+        uint64_t period_ = 0;
+        uint64_t countdown_ = 0;
+    };
+
+    //     .    -   
+    inline void ChargeStep(Context& context) {
+        if (ExecutionBudget* budget = context.GetExecutionBudget()) {
+            budget->Charge();
+        }
+    }
+
+}  // namespace runtime
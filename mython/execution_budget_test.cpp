@@ -0,0 +1,192 @@
+#include "execution_budget.h"
+#include "lexer.h"
+#include "mython.h"
+#include "parse.h"
+#include "server.h"
+#include "tasks.h"
+#include "test_runner_p.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+
+        void TestExecutionBudget() {
+            const string runaway = R"(
+class Runaway:
+  def loop(n):
+    return self.loop(n + 1)
+
+r = Runaway()
+r.loop(0)
+)"s;
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+
+            //  -    .       
+            const mython::CompiledProgram simple = mython::Compile("x = 1\ny = 2\nprint x + y\n"sv);
+            {
+                runtime::ExecutionBudget budget(3);
+                context.SetExecutionBudget(&budget);
+                mython::Run(simple, context);
+                ASSERT_EQUAL(budget.GetUsed(), 3u);
+            }
+            {
+                runtime::ExecutionBudget budget(2);
+                context.SetExecutionBudget(&budget);
+                ASSERT_THROWS(mython::Run(simple, context), runtime::BudgetExceededError);
+                //        
+                ASSERT_THROWS(budget.Charge(), runtime::BudgetExceededError);
+            }
+
+            //       ,      ast
+            {
+                runtime::ExecutionBudget budget(2000);
+                context.SetExecutionBudget(&budget);
+                ASSERT_THROWS(mython::Run(mython::Compile(runaway), context), runtime::BudgetExceededError);
+            }
+            {
+                runtime::ExecutionBudget budget(2000);
+                context.SetExecutionBudget(&budget);
+                istringstream input(runaway);
+                parse::Lexer lexer(input);
+                auto program = ParseProgram(lexer);
+                runtime::Closure closure;
+                ASSERT_THROWS(program->Execute(closure, context), runtime::BudgetExceededError);
+            }
+            context.SetExecutionBudget(nullptr);
+            ASSERT_EQUAL(output.str(), "3\n"s);
+
+            //  spawn   
+            ostringstream task_output;
+            runtime::TaskScheduler scheduler{ task_output, 1 };
+            scheduler.SetTaskStepLimit(2000);
+            const mython::CompiledProgram spawning = mython::Compile(R"(
+class Runaway:
+  def loop(n):
+    return self.loop(n + 1)
+
+r = Runaway()
+spawn r.loop(0)
+)"sv);
+            mython::Run(spawning, scheduler.GetContext());
+            ASSERT_THROWS(scheduler.Wait(), runtime::BudgetExceededError);
+
+            //   ,  , 
+            const auto dir = filesystem::temp_directory_path() / "mython_budget_test"s;
+            filesystem::create_directories(dir);
+            {
+                mython::Server server({ (dir / "server.sock"s).string(), 1, 2, 2000 });
+                ostringstream server_output;
+                const mython::ServerResponse response = server.Execute({ runaway, 0, {} }, server_output);
+                ASSERT(!response.ok);
+                ASSERT_EQUAL(response.error, "Execution budget of 2000 steps exceeded"s);
+                ASSERT(server.Execute({ "print stdin\n"s, 0, "ok"s }, server_output).ok);
+            }
+            filesystem::remove_all(dir);
+        }
+
+        void TestCallDepth() {
+            //         ,   
+            //  .   str       
+            const string runaway = R"(
+class Runaway:
+  def loop(n):
+    return str(1 + self.loop(n + 1))
+
+r = Runaway()
+r.loop(0)
+)"s;
+            const string depth_error = "Maximum call depth of "s + to_string(runtime::Context::DEFAULT_MAX_CALL_DEPTH)
+                + " exceeded"s;
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            ASSERT_EQUAL(context.GetMaxCallDepth(), 0u);
+            context.SetMaxCallDepth(runtime::Context::DEFAULT_MAX_CALL_DEPTH);
+            try {
+                mython::Run(mython::Compile(runaway), context);
+                ASSERT(false);
+            }
+            catch (const runtime::BudgetExceededError& e) {
+                ASSERT_EQUAL(string(e.what()), depth_error);
+            }
+            {
+                istringstream input(runaway);
+                parse::Lexer lexer(input);
+                auto program = ParseProgram(lexer);
+                runtime::Closure closure;
+                ASSERT_THROWS(program->Execute(closure, context), runtime::BudgetExceededError);
+            }
+
+            //    ;     
+            const mython::CompiledProgram counter = mython::Compile(R"(
+class Counter:
+  def down(n):
+    if n > 0:
+      return self.down(n - 1)
+    return n
+
+c = Counter()
+print c.down(depth)
+)"sv);
+            context.SetMaxCallDepth(10);
+            ASSERT_THROWS(mython::Run(counter, context, { { "depth"s, ObjectHolder::Own(Number(10)) } }),
+                runtime::BudgetExceededError);
+            mython::Run(counter, context, { { "depth"s, ObjectHolder::Own(Number(9)) } });
+            context.SetMaxCallDepth(0);
+            //      ,    
+            mython::Run(counter, context, { { "depth"s, ObjectHolder::Own(Number(3000)) } });
+            ASSERT_EQUAL(output.str(), "0\n0\n"s);
+
+            // SuspendableRun,          
+            {
+                mython::SuspendableRun run(mython::Compile(runaway), context, 1'000'000);
+                ASSERT(run.RunSlice() == mython::SuspendableRun::State::Failed);
+                ASSERT_EQUAL(context.GetMaxCallDepth(), 0u);
+            }
+            ostringstream task_output;
+            runtime::TaskScheduler scheduler{ task_output, 1 };
+            scheduler.SetTaskStepLimit(1'000'000);
+            const mython::CompiledProgram spawning = mython::Compile(R"(
+class Runaway:
+  def loop(n):
+    return self.loop(n + 1)
+
+r = Runaway()
+spawn r.loop(0)
+)"sv);
+            mython::Run(spawning, scheduler.GetContext());
+            ASSERT_THROWS(scheduler.Wait(), runtime::BudgetExceededError);
+
+            const auto dir = filesystem::temp_directory_path() / "mython_depth_test"s;
+            filesystem::create_directories(dir);
+            {
+                mython::Server server({ (dir / "server.sock"s).string(), 1, 2, 1'000'000 });
+                ostringstream server_output;
+                const mython::ServerResponse response = server.Execute({ runaway, 0, {} }, server_output);
+                ASSERT(!response.ok);
+                ASSERT_EQUAL(response.error, depth_error);
+            }
+            {
+                //        
+                mython::Server server({ (dir / "server.sock"s).string(), 1, 2, 0, 10 });
+                ostringstream server_output;
+                const mython::ServerResponse response = server.Execute({ runaway, 0, {} }, server_output);
+                ASSERT_EQUAL(response.error, "Maximum call depth of 10 exceeded"s);
+            }
+            filesystem::remove_all(dir);
+        }
+
+    }  // namespace
+
+    void RunExecutionBudgetTests(TestRunner& tr) {
+        RUN_TEST(tr, runtime::TestExecutionBudget);
+        RUN_TEST(tr, runtime::TestCallDepth);
+    }
+
+}  // namespace runtime
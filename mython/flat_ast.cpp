@@ -0,0 +1,632 @@
+#include "flat_ast.h"
+
+#include "execution_budget.h"
+#include "heap_profiler.h"
+#include "tasks.h"
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+
+using namespace std;
+
+namespace flat_ast {
+
+    using runtime::Closure;
+    using runtime::Context;
+    using runtime::ObjectHolder;
+
+    namespace {
+        const string INIT_METHOD = "__init__"s;
+        const string ADD_METHOD = "__add__"s;
+
+        //     ,       Node::op
+        const array<Comparator, COMPARATOR_COUNT> COMPARATORS = {
+            runtime::Equal, runtime::NotEqual, runtime::Less,
+            runtime::Greater, runtime::LessOrEqual, runtime::GreaterOrEqual,
+        };
+
+        bool GetBool(const ObjectHolder& object) {
+            const auto* value = object.TryAs<runtime::Bool>();
+            if (!value) {
+                throw runtime_error("Logical operation requires Bool operands"s);
+            }
+            return value->GetValue();
+        }
+    }  // namespace
+
+    ObjectHolder Tree::Execute(NodeIndex node, Closure& closure, Context& context) const {
+        bool returned = false;
+        return Eval(node, closure, context, returned);
+    }
+
+    void Tree::PinConstants(Closure& closure) const {
+        for (auto& [name, value] : closure) {
+            value = Pin(std::move(value));
+        }
+    }
+
+    ObjectHolder Tree::Pin(ObjectHolder value) const {
+        if (!value || value.IsOwning()) {
+            return value;
+        }
+        const runtime::Object* object = value.Get();
+        const less<const runtime::Object*> before;
+        const bool constant = object == &true_ || object == &false_
+            || (!numbers_.empty() && !before(object, &numbers_.front()) && !before(&numbers_.back(), object))
+            || (!strings_.empty() && !before(object, &strings_.front()) && !before(&strings_.back(), object))
+            || any_of(class_holders_.begin(), class_holders_.end(), [object](const ObjectHolder& cls) {
+                return cls.Get() == object;
+            });
+        return constant ? ObjectHolder::ShareConstant(*object, shared_from_this()) : value;
+    }
+
+    ObjectHolder Tree::ExecuteBody(NodeIndex body, Closure& closure, Context& context) const {
+        bool returned = false;
+        ObjectHolder result = Eval(body, closure, context, returned);
+        return returned ? result : ObjectHolder::None();
+    }
+
+    ObjectHolder Tree::Eval(NodeIndex index, Closure& closure, Context& context, bool& returned) const {
+        const Node& node = nodes_[index];
+
+        switch (node.kind) {
+        case NodeKind::NumericConst:
+            return ObjectHolder::ShareConstant(numbers_[node.arg[0]]);
+        case NodeKind::StringConst:
+            return ObjectHolder::ShareConstant(strings_[node.arg[0]]);
+        case NodeKind::BoolConst:
+            return ObjectHolder::ShareConstant(node.op ? true_ : false_);
+        case NodeKind::None:
+            return {};
+        case NodeKind::VariableValue:
+            return ExecuteVariableValue(node, closure);
+        case NodeKind::Assignment: {
+            const string& var = names_[node.arg[0]];
+            ObjectHolder value = Eval(node.arg[1], closure, context, returned);
+            closure[var] = value;
+            return value;
+        }
+        case NodeKind::FieldAssignment: {
+            auto* cls = Eval(node.arg[0], closure, context, returned).TryAs<runtime::ClassInstance>();
+            if (!cls) {
+                throw runtime_error("no class"s);
+            }
+            ObjectHolder value = Eval(node.arg[2], closure, context, returned);
+            //         
+            if (cls->GetClassOwner().get() != this) {
+                value = Pin(std::move(value));
+            }
+            cls->Fields()[names_[node.arg[1]]] = value;
+            return value;
+        }
+        case NodeKind::Print:
+            return ExecutePrint(node, closure, context);
+        case NodeKind::MethodCall:
+            return ExecuteMethodCall(node, closure, context);
+        case NodeKind::NewInstance:
+            return ExecuteNewInstance(node, closure, context);
+        case NodeKind::Stringify:
+            return ExecuteStringify(node, closure, context);
+        case NodeKind::Add:
+        case NodeKind::Sub:
+        case NodeKind::Mult:
+        case NodeKind::Div:
+            return ExecuteArithmetic(node, closure, context);
+        case NodeKind::Or:
+            if (!GetBool(Eval(node.arg[0], closure, context, returned))) {
+                return ObjectHolder::Own(runtime::Bool(GetBool(Eval(node.arg[1], closure, context, returned))));
+            }
+            return ObjectHolder::Own(runtime::Bool(true));
+        case NodeKind::And:
+            if (GetBool(Eval(node.arg[0], closure, context, returned))) {
+                return ObjectHolder::Own(runtime::Bool(GetBool(Eval(node.arg[1], closure, context, returned))));
+            }
+            return ObjectHolder::Own(runtime::Bool(false));
+        case NodeKind::Not:
+            return ObjectHolder::Own(runtime::Bool(!GetBool(Eval(node.arg[0], closure, context, returned))));
+        case NodeKind::Comparison: {
+            ObjectHolder lhs = Eval(node.arg[0], closure, context, returned);
+            ObjectHolder rhs = Eval(node.arg[1], closure, context, returned);
+            return ObjectHolder::Own(runtime::Bool(COMPARATORS[node.op](lhs, rhs, context)));
+        }
+        case NodeKind::Compound: {
+            //      ,      
+            runtime::ExecutionBudget* budget = context.GetExecutionBudget();
+            for (uint32_t i = node.items; i < node.items + node.count; ++i) {
+                if (budget) {
+                    budget->Charge();
+                }
+                ObjectHolder result = Eval(lists_[i], closure, context, returned);
+                if (returned) {
+                    return result;
+                }
+            }
+            return {};
+        }
+        case NodeKind::Return: {
+            //  ,   ast::Return,  ,   Compound
+            //   
+            ObjectHolder result = Eval(node.arg[0], closure, context, returned);
+            returned = true;
+            return result;
+        }
+        case NodeKind::ClassDefinition: {
+            const auto& cls = *class_holders_[node.arg[0]].TryAs<runtime::Class>();
+            ObjectHolder holder = ObjectHolder::ShareConstant(cls);
+            closure[cls.GetName()] = holder;
+            return holder;
+        }
+        case NodeKind::IfElse:
+            if (runtime::IsTrue(Eval(node.arg[0], closure, context, returned))) {
+                return Eval(node.arg[1], closure, context, returned);
+            }
+            if (node.arg[2] != NO_NODE) {
+                return Eval(node.arg[2], closure, context, returned);
+            }
+            return {};
+        case NodeKind::Spawn:
+            return ExecuteSpawn(node, closure, context);
+        case NodeKind::NewChannel:
+            return runtime::MakeChannel(Eval(node.arg[0], closure, context, returned));
+        case NodeKind::Yield:
+            throw runtime_error("yield outside a generator"s);
+        }
+        throw logic_error("Unknown node kind"s);
+    }
+
+    void Tree::ResumeBody(NodeIndex body, Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        bool returned = false;
+        Resume(body, closure, context, frame, returned);
+        if (returned) {
+            frame.suspended = false;
+        }
+    }
+
+    void Tree::Resume(NodeIndex index, Closure& closure, Context& context, runtime::GeneratorFrame& frame,
+        bool& returned) const {
+        const Node& node = nodes_[index];
+
+        switch (node.kind) {
+        case NodeKind::Compound: {
+            uint32_t i = 0;
+            if (frame.resuming) {
+                i = frame.path.back();
+                frame.path.pop_back();
+            }
+            for (; i < node.count; ++i) {
+                Resume(lists_[node.items + i], closure, context, frame, returned);
+                if (returned) {
+                    return;
+                }
+                if (frame.suspended) {
+                    frame.path.push_back(i);
+                    frame.tail = frame.tail && i + 1 == node.count;
+                    return;
+                }
+            }
+            return;
+        }
+        case NodeKind::IfElse: {
+            // ,    : 0 - if, 1 - else
+            uint32_t branch = 0;
+            if (frame.resuming) {
+                branch = frame.path.back();
+                frame.path.pop_back();
+            }
+            else if (!runtime::IsTrue(Eval(node.arg[0], closure, context, returned))) {
+                branch = 1;
+            }
+            if (node.arg[1 + branch] != NO_NODE) {
+                Resume(node.arg[1 + branch], closure, context, frame, returned);
+                if (frame.suspended) {
+                    frame.path.push_back(branch);
+                }
+            }
+            return;
+        }
+        case NodeKind::Yield:
+            if (frame.resuming) {
+                //    ,    yield
+                frame.resuming = false;
+                return;
+            }
+            frame.value = Eval(node.arg[0], closure, context, returned);
+            frame.suspended = true;
+            frame.delegate = node.op != 0;
+            frame.tail = true;
+            return;
+        default:
+            Eval(index, closure, context, returned);
+        }
+    }
+
+    ObjectHolder Tree::ExecuteVariableValue(const Node& node, Closure& closure) const {
+        const auto it = closure.find(names_[lists_[node.items]]);
+        if (it == closure.end()) {
+            throw runtime_error("Wrong arg"s);
+        }
+        ObjectHolder obj = it->second;
+        for (uint32_t i = node.items + 1; i < node.items + node.count; ++i) {
+            auto* instance = obj.TryAs<runtime::ClassInstance>();
+            if (!instance) {
+                throw runtime_error("Wrong arg"s);
+            }
+            const auto field = instance->Fields().find(names_[lists_[i]]);
+            if (field == instance->Fields().end()) {
+                throw runtime_error("Wrong arg"s);
+            }
+            obj = field->second;
+        }
+        return obj;
+    }
+
+    ObjectHolder Tree::ExecuteMethodCall(const Node& node, Closure& closure, Context& context) const {
+        runtime::ChargeStep(context);
+        vector<ObjectHolder> args;
+        args.reserve(node.count);
+        for (uint32_t i = node.items; i < node.items + node.count; ++i) {
+            args.push_back(Execute(lists_[i], closure, context));
+        }
+
+        ObjectHolder object = Execute(node.arg[0], closure, context);
+        auto* instance = object.TryAs<runtime::ClassInstance>();
+        if (!instance) {
+            if (auto* generator = object.TryAs<runtime::Generator>()) {
+                return generator->Call(names_[node.arg[1]], args, context);
+            }
+            if (auto* channel = object.TryAs<runtime::Channel>()) {
+                return channel->Call(names_[node.arg[1]], args, context);
+            }
+            throw runtime_error("Cannot find class"s);
+        }
+        return instance->Call(names_[node.arg[1]], args, context);
+    }
+
+    ObjectHolder Tree::ExecuteSpawn(const Node& node, Closure& closure, Context& context) const {
+        vector<ObjectHolder> args;
+        args.reserve(node.count);
+        for (uint32_t i = node.items; i < node.items + node.count; ++i) {
+            args.push_back(Execute(lists_[i], closure, context));
+        }
+        runtime::SpawnTask(context, Execute(node.arg[0], closure, context), names_[node.arg[1]], args);
+        return {};
+    }
+
+    ObjectHolder Tree::ExecuteNewInstance(const Node& node, Closure& closure, Context& context) const {
+        ObjectHolder obj = runtime::Allocate(runtime::ClassInstance(*classes_[node.arg[0]], shared_from_this()),
+            context);
+        auto* instance = obj.TryAs<runtime::ClassInstance>();
+        if (instance->HasMethod(INIT_METHOD, node.count)) {
+            vector<ObjectHolder> args;
+            args.reserve(node.count);
+            for (uint32_t i = node.items; i < node.items + node.count; ++i) {
+                args.push_back(Execute(lists_[i], closure, context));
+            }
+            instance->Call(INIT_METHOD, args, context);
+        }
+        return obj;
+    }
+
+    ObjectHolder Tree::ExecutePrint(const Node& node, Closure& closure, Context& context) const {
+        auto& output = context.GetOutputStream();
+        for (uint32_t i = node.items; i < node.items + node.count; ++i) {
+            ObjectHolder value = Execute(lists_[i], closure, context);
+            if (i != node.items) {
+                output << ' ';
+            }
+            if (value) {
+                value->Print(output, context);
+            }
+            else {
+                output << "None"sv;
+            }
+        }
+        output << '\n';
+        return {};
+    }
+
+    ObjectHolder Tree::ExecuteStringify(const Node& node, Closure& closure, Context& context) const {
+        ObjectHolder argument = Execute(node.arg[0], closure, context);
+        if (const auto* str = argument.TryAs<runtime::String>()) {
+            return runtime::Allocate(runtime::String(*str), context, &node, "Stringify"sv);
+        }
+        ostringstream os;
+        if (argument) {
+            argument->Print(os, context);
+        }
+        else {
+            os << "None"sv;
+        }
+        return runtime::Allocate(runtime::String(os.str()), context, &node, "Stringify"sv);
+    }
+
+    ObjectHolder Tree::ExecuteArithmetic(const Node& node, Closure& closure, Context& context) const {
+        ObjectHolder lhs = Execute(node.arg[0], closure, context);
+        ObjectHolder rhs = Execute(node.arg[1], closure, context);
+
+        const auto* lhs_number = lhs.TryAs<runtime::Number>();
+        const auto* rhs_number = rhs.TryAs<runtime::Number>();
+        if (lhs_number && rhs_number) {
+            const int lhs_value = lhs_number->GetValue();
+            const int rhs_value = rhs_number->GetValue();
+            switch (node.kind) {
+            case NodeKind::Add:
+                return runtime::Allocate(runtime::Number(lhs_value + rhs_value), context, &node, "Add"sv);
+            case NodeKind::Sub:
+                return runtime::Allocate(runtime::Number(lhs_value - rhs_value), context, &node, "Sub"sv);
+            case NodeKind::Mult:
+                return runtime::Allocate(runtime::Number(lhs_value * rhs_value), context, &node, "Mult"sv);
+            default:
+                if (rhs_value == 0) {
+                    throw runtime_error("Div na 0"s);
+                }
+                return runtime::Allocate(runtime::Number(lhs_value / rhs_value), context, &node, "Div"sv);
+            }
+        }
+
+        if (node.kind == NodeKind::Add) {
+            const auto* lhs_string = lhs.TryAs<runtime::String>();
+            const auto* rhs_string = rhs.TryAs<runtime::String>();
+            if (lhs_string && rhs_string) {
+                return runtime::Allocate(runtime::String::Concat(*lhs_string, *rhs_string), context, &node, "Add"sv);
+            }
+            if (auto* instance = lhs.TryAs<runtime::ClassInstance>();
+                instance && instance->HasMethod(ADD_METHOD, 1)) {
+                return instance->Call(ADD_METHOD, { rhs }, context);
+            }
+        }
+        throw runtime_error("Unsupported operand types for arithmetic operation"s);
+    }
+
+    MethodBody::MethodBody(Tree& tree, NodeIndex body)
+        : tree_(tree), body_(body) {
+    }
+
+    ObjectHolder MethodBody::Execute(Closure& closure, Context& context) const {
+        return tree_.ExecuteBody(body_, closure, context);
+    }
+
+    ObjectHolder MethodBody::Resume(Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        tree_.ResumeBody(body_, closure, context, frame);
+        return {};
+    }
+
+    Program::Program(std::shared_ptr<Tree> tree, NodeIndex root)
+        : tree_(std::move(tree)), root_(root) {
+    }
+
+    ObjectHolder Program::Execute(Closure& closure, Context& context) const {
+        //    ,      
+        //     ,     
+        ObjectHolder result;
+        try {
+            result = tree_->Execute(root_, closure, context);
+        }
+        catch (...) {
+            tree_->PinConstants(closure);
+            throw;
+        }
+        tree_->PinConstants(closure);
+        return result;
+    }
+
+    Builder::Builder()
+        : tree_(make_shared<Tree>()) {
+    }
+
+    Builder::Node Builder::AddNode(flat_ast::Node node) {
+        tree_->node_storage_.push_back(node);
+        tree_->nodes_ = tree_->node_storage_.data();
+        tree_->node_count_ = tree_->node_storage_.size();
+        return { static_cast<NodeIndex>(tree_->node_count_ - 1) };
+    }
+
+    Builder::Node Builder::AddUnary(NodeKind kind, Node argument) {
+        flat_ast::Node node{ kind };
+        node.arg[0] = argument.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::AddBinary(NodeKind kind, Node lhs, Node rhs) {
+        flat_ast::Node node{ kind };
+        node.arg[0] = lhs.index;
+        node.arg[1] = rhs.index;
+        return AddNode(node);
+    }
+
+    void Builder::SetItems(flat_ast::Node& node, const vector<uint32_t>& items) {
+        node.items = static_cast<uint32_t>(tree_->list_storage_.size());
+        node.count = static_cast<uint32_t>(items.size());
+        tree_->list_storage_.insert(tree_->list_storage_.end(), items.begin(), items.end());
+        tree_->lists_ = tree_->list_storage_.data();
+        tree_->list_count_ = tree_->list_storage_.size();
+    }
+
+    void Builder::SetItems(flat_ast::Node& node, const vector<Node>& items) {
+        node.items = static_cast<uint32_t>(tree_->list_storage_.size());
+        node.count = static_cast<uint32_t>(items.size());
+        for (const Node item : items) {
+            tree_->list_storage_.push_back(item.index);
+        }
+        tree_->lists_ = tree_->list_storage_.data();
+        tree_->list_count_ = tree_->list_storage_.size();
+    }
+
+    uint32_t Builder::AddName(string name) {
+        const auto [it, inserted] = name_indices_.emplace(name, static_cast<uint32_t>(tree_->names_.size()));
+        if (inserted) {
+            tree_->names_.push_back(std::move(name));
+        }
+        return it->second;
+    }
+
+    Builder::Node Builder::NumericConst(int value) {
+        flat_ast::Node node{ NodeKind::NumericConst };
+        node.arg[0] = static_cast<uint32_t>(tree_->numbers_.size());
+        tree_->numbers_.emplace_back(value);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::StringConst(string value) {
+        flat_ast::Node node{ NodeKind::StringConst };
+        node.arg[0] = static_cast<uint32_t>(tree_->strings_.size());
+        tree_->strings_.emplace_back(std::move(value));
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::BoolConst(bool value) {
+        flat_ast::Node node{ NodeKind::BoolConst };
+        node.op = value ? 1 : 0;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::None() {
+        return AddNode({ NodeKind::None });
+    }
+
+    Builder::Node Builder::VariableValue(vector<string> dotted_ids) {
+        vector<uint32_t> names;
+        names.reserve(dotted_ids.size());
+        for (auto& id : dotted_ids) {
+            names.push_back(AddName(std::move(id)));
+        }
+        flat_ast::Node node{ NodeKind::VariableValue };
+        SetItems(node, names);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Assignment(string var, Node rv) {
+        flat_ast::Node node{ NodeKind::Assignment };
+        node.arg[0] = AddName(std::move(var));
+        node.arg[1] = rv.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::FieldAssignment(vector<string> object, string field_name, Node rv) {
+        flat_ast::Node node{ NodeKind::FieldAssignment };
+        node.arg[0] = VariableValue(std::move(object)).index;
+        node.arg[1] = AddName(std::move(field_name));
+        node.arg[2] = rv.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Print(vector<Node> args) {
+        flat_ast::Node node{ NodeKind::Print };
+        SetItems(node, args);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::MethodCall(Node object, string method, vector<Node> args) {
+        flat_ast::Node node{ NodeKind::MethodCall };
+        node.arg[0] = object.index;
+        node.arg[1] = AddName(std::move(method));
+        SetItems(node, args);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::NewInstance(const runtime::Class& cls, vector<Node> args) {
+        flat_ast::Node node{ NodeKind::NewInstance };
+        node.arg[0] = static_cast<uint32_t>(tree_->classes_.size());
+        tree_->classes_.push_back(&cls);
+        SetItems(node, args);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Stringify(Node argument) {
+        return AddUnary(NodeKind::Stringify, argument);
+    }
+
+    Builder::Node Builder::Add(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::Add, lhs, rhs);
+    }
+
+    Builder::Node Builder::Sub(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::Sub, lhs, rhs);
+    }
+
+    Builder::Node Builder::Mult(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::Mult, lhs, rhs);
+    }
+
+    Builder::Node Builder::Div(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::Div, lhs, rhs);
+    }
+
+    Builder::Node Builder::Or(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::Or, lhs, rhs);
+    }
+
+    Builder::Node Builder::And(Node lhs, Node rhs) {
+        return AddBinary(NodeKind::And, lhs, rhs);
+    }
+
+    Builder::Node Builder::Not(Node argument) {
+        return AddUnary(NodeKind::Not, argument);
+    }
+
+    Builder::Node Builder::Comparison(Comparator cmp, Node lhs, Node rhs) {
+        flat_ast::Node node{ NodeKind::Comparison };
+        const auto it = find(COMPARATORS.begin(), COMPARATORS.end(), cmp);
+        if (it == COMPARATORS.end()) {
+            throw logic_error("Unknown comparator"s);
+        }
+        node.op = static_cast<uint8_t>(it - COMPARATORS.begin());
+        node.arg[0] = lhs.index;
+        node.arg[1] = rhs.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Compound(vector<Node> statements) {
+        flat_ast::Node node{ NodeKind::Compound };
+        SetItems(node, statements);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Return(Node statement) {
+        return AddUnary(NodeKind::Return, statement);
+    }
+
+    Builder::Node Builder::Yield(Node statement, bool delegate) {
+        flat_ast::Node node{ NodeKind::Yield };
+        node.op = delegate ? 1 : 0;
+        node.arg[0] = statement.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::ClassDefinition(ObjectHolder cls) {
+        flat_ast::Node node{ NodeKind::ClassDefinition };
+        node.arg[0] = static_cast<uint32_t>(tree_->class_holders_.size());
+        tree_->class_holders_.push_back(std::move(cls));
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::IfElse(Node condition, Node if_body, Node else_body) {
+        flat_ast::Node node{ NodeKind::IfElse };
+        node.arg[0] = condition.index;
+        node.arg[1] = if_body.index;
+        node.arg[2] = else_body.index;
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::Spawn(Node object, string method, vector<Node> args) {
+        flat_ast::Node node{ NodeKind::Spawn };
+        node.arg[0] = object.index;
+        node.arg[1] = AddName(std::move(method));
+        SetItems(node, args);
+        return AddNode(node);
+    }
+
+    Builder::Node Builder::NewChannel(Node capacity) {
+        return AddUnary(NodeKind::NewChannel, capacity);
+    }
+
+    unique_ptr<runtime::Executable> Builder::MethodBody(Node body) {
+        return make_unique<flat_ast::MethodBody>(*tree_, body.index);
+    }
+
+    unique_ptr<runtime::Executable> Builder::Program(Node body) {
+        return make_unique<flat_ast::Program>(std::move(tree_), body.index);
+    }
+
+}  // namespace flat_ast
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//    .       
+//  ,    32- ,   
+//        .
+//          statement.h
+namespace flat_ast {
+
+    using NodeIndex = uint32_t;
+
+    //  ,   else  if  else
+    inline constexpr NodeIndex NO_NODE = std::numeric_limits<NodeIndex>::max();
+
+    enum class NodeKind : uint8_t {
+        NumericConst,     // arg[0] -   numbers_
+        StringConst,      // arg[0] -   strings_
+        BoolConst,        // op - 
+        None,
+        VariableValue,    // items/count -    names_
+        Assignment,       // arg[0] -  , arg[1] - 
+        FieldAssignment,  // arg[0] - VariableValue , arg[1] -  , arg[2] - 
+        Print,            // items/count - 
+        MethodCall,       // arg[0] - , arg[1] -  , items/count - 
+        NewInstance,      // arg[0] -   classes_, items/count - 
+        Stringify,        // arg[0] - 
+        Add,              // arg[0], arg[1] - 
+        Sub,
+        Mult,
+        Div,
+        Or,
+        And,
+        Not,              // arg[0] - 
+        Comparison,       // op -  , arg[0], arg[1] - 
+        Compound,         // items/count - 
+        Return,           // arg[0] -  
+        ClassDefinition,  // arg[0] -   class_holders_
+        IfElse,           // arg[0] - , arg[1] -  if, arg[2] -  else  NO_NODE
+        Spawn,            // arg[0] - , arg[1] -  , items/count - 
+        NewChannel,       // arg[0] -  
+        Yield,            // arg[0] - , op - yield from
+    };
+
+    //  .  (, ,  )     
+    // lists_,     items    count.
+    //        ,  Node   
+    struct Node {
+        NodeKind kind;
+        uint8_t op = 0;
+        uint32_t arg[3] = { NO_NODE, NO_NODE, NO_NODE };
+        uint32_t items = 0;
+        uint32_t count = 0;
+    };
+
+    //   ,  Builder.    
+    struct NodeRef {
+        NodeIndex index = NO_NODE;
+    };
+
+    using Comparator = bool (*)(const runtime::ObjectHolder&, const runtime::ObjectHolder&, runtime::Context&);
+
+    //   : op  Comparison  
+    inline constexpr size_t COMPARATOR_COUNT = 6;
+
+    //    .    std::shared_ptr: ,  
+    //  ,  ,   .    
+    //  ,        ObjectHolder  
+    //        .     ,
+    //   , . PinConstants
+    class Tree : public std::enable_shared_from_this<Tree> {
+    public:
+        //   node
+        runtime::ObjectHolder Execute(NodeIndex node, runtime::Closure& closure, runtime::Context& context) const;
+        //      ,   return,  None
+        runtime::ObjectHolder ExecuteBody(NodeIndex body, runtime::Closure& closure, runtime::Context& context) const;
+        //   -   yield, . runtime::Executable::Resume
+        void ResumeBody(NodeIndex body, runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const;
+
+        [[nodiscard]] size_t GetNodeCount() const {
+            return node_count_;
+        }
+
+        //          closure ,
+        //   
+        void PinConstants(runtime::Closure& closure) const;
+
+        // ,   ,   
+        [[nodiscard]] const std::vector<runtime::ObjectHolder>& GetClasses() const {
+            return class_holders_;
+        }
+
+    private:
+        friend class Builder;
+        friend class LaneEvaluator;
+        friend class ProgramCache;
+
+        // returned   Return     Compound
+        runtime::ObjectHolder Eval(NodeIndex index, runtime::Closure& closure, runtime::Context& context,
+            bool& returned) const;
+        //     .  ,   yield  
+        // frame  ,     Eval
+        void Resume(NodeIndex index, runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame, bool& returned) const;
+
+        //  value,   ,  value -    
+        //   ,  value     
+        runtime::ObjectHolder Pin(runtime::ObjectHolder value) const;
+
+        runtime::ObjectHolder ExecuteVariableValue(const Node& node, runtime::Closure& closure) const;
+        runtime::ObjectHolder ExecuteMethodCall(const Node& node, runtime::Closure& closure,
+            runtime::Context& context) const;
+        runtime::ObjectHolder ExecuteSpawn(const Node& node, runtime::Closure& closure, runtime::Context& context) const;
+        runtime::ObjectHolder ExecuteNewInstance(const Node& node, runtime::Closure& closure,
+            runtime::Context& context) const;
+        runtime::ObjectHolder ExecutePrint(const Node& node, runtime::Closure& closure, runtime::Context& context) const;
+        //   Eval,          
+        runtime::ObjectHolder ExecuteStringify(const Node& node, runtime::Closure& closure,
+            runtime::Context& context) const;
+        runtime::ObjectHolder ExecuteArithmetic(const Node& node, runtime::Closure& closure,
+            runtime::Context& context) const;
+
+        //      node_storage_  list_storage_,     ,
+        //     ,   storage_owner_
+        const Node* nodes_ = nullptr;
+        const uint32_t* lists_ = nullptr;
+        size_t node_count_ = 0;
+        size_t list_count_ = 0;
+        std::vector<Node> node_storage_;
+        std::vector<uint32_t> list_storage_;
+        std::shared_ptr<const void> storage_owner_;
+        std::vector<std::string> names_;
+        std::vector<runtime::Number> numbers_;
+        std::vector<runtime::String> strings_;
+        std::vector<const runtime::Class*> classes_;
+        std::vector<runtime::ObjectHolder> class_holders_;
+        runtime::Bool true_{ true };
+        runtime::Bool false_{ false };
+    };
+
+    //  ,    .   ,   - , 
+    //     :    .  ,   ,
+    //     ObjectHolder,     
+    class MethodBody : public runtime::Executable {
+    public:
+        MethodBody(Tree& tree, NodeIndex body);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
+
+        [[nodiscard]] NodeIndex GetBody() const {
+            return body_;
+        }
+
+        [[nodiscard]] const Tree& GetTree() const {
+            return tree_;
+        }
+
+    private:
+        Tree& tree_;
+        NodeIndex body_;
+    };
+
+    //  :  ,    
+    class Program : public runtime::Executable {
+    public:
+        Program(std::shared_ptr<Tree> tree, NodeIndex root);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+
+        [[nodiscard]] const Tree& GetTree() const {
+            return *tree_;
+        }
+
+        [[nodiscard]] NodeIndex GetRoot() const {
+            return root_;
+        }
+
+    private:
+        std::shared_ptr<Tree> tree_;
+        NodeIndex root_;
+    };
+
+    //       .    
+    //    ast,   Parser
+    class Builder {
+    public:
+        using Node = NodeRef;
+
+        Builder();
+
+        Node NumericConst(int value);
+        Node StringConst(std::string value);
+        Node BoolConst(bool value);
+        Node None();
+        Node VariableValue(std::vector<std::string> dotted_ids);
+        Node Assignment(std::string var, Node rv);
+        Node FieldAssignment(std::vector<std::string> object, std::string field_name, Node rv);
+        Node Print(std::vector<Node> args);
+        Node MethodCall(Node object, std::string method, std::vector<Node> args);
+        Node NewInstance(const runtime::Class& cls, std::vector<Node> args);
+        Node Stringify(Node argument);
+        Node Add(Node lhs, Node rhs);
+        Node Sub(Node lhs, Node rhs);
+        Node Mult(Node lhs, Node rhs);
+        Node Div(Node lhs, Node rhs);
+        Node Or(Node lhs, Node rhs);
+        Node And(Node lhs, Node rhs);
+        Node Not(Node argument);
+        Node Comparison(Comparator cmp, Node lhs, Node rhs);
+        Node Compound(std::vector<Node> statements);
+        Node Return(Node statement);
+        Node Yield(Node statement, bool delegate);
+        Node ClassDefinition(runtime::ObjectHolder cls);
+        Node IfElse(Node condition, Node if_body, Node else_body);
+        Node Spawn(Node object, std::string method, std::vector<Node> args);
+        Node NewChannel(Node capacity);
+
+        std::unique_ptr<runtime::Executable> MethodBody(Node body);
+        std::unique_ptr<runtime::Executable> Program(Node body);
+
+    private:
+        Node AddNode(flat_ast::Node node);
+        Node AddUnary(NodeKind kind, Node argument);
+        Node AddBinary(NodeKind kind, Node lhs, Node rhs);
+        //    list_storage_      node
+        void SetItems(flat_ast::Node& node, const std::vector<uint32_t>& items);
+        void SetItems(flat_ast::Node& node, const std::vector<Node>& items);
+        uint32_t AddName(std::string name);
+
+        std::shared_ptr<Tree> tree_;
+        std::unordered_map<std::string, uint32_t> name_indices_;
+    };
+
+}  // namespace flat_ast
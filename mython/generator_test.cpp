@@ -0,0 +1,163 @@
+#include "lexer.h"
+#include "parse.h"
+#include "runtime.h"
+#include "test_runner_p.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+
+        //       ast   
+        void RunProgram(istream& input, ostream& output) {
+            parse::Lexer lexer(input);
+            auto program = ParseProgram(lexer);
+            SimpleContext context{ output };
+            Closure closure;
+            program->Execute(closure, context);
+        }
+
+        //  ,       
+        void RunLazyProgram(unique_ptr<parse::Lexer> lexer, ostream& output) {
+            auto program = ParseLazyProgram(std::move(lexer));
+            SimpleContext context{ output };
+            Closure closure;
+            program->Execute(closure, context);
+        }
+
+        void TestGenerators() {
+            const string program = R"(
+class Source:
+  def range(i, n):
+    if i < n:
+      yield i
+      yield from self.range(i + 1, n)
+
+class Pipeline:
+  def squares(g):
+    if g.has_next():
+      v = g.next()
+      yield v * v
+      yield from self.squares(g)
+
+  def evens(g):
+    if g.has_next():
+      v = g.next()
+      if v / 2 * 2 == v:
+        yield v
+      yield from self.evens(g)
+
+  def wrap(g):
+    yield "begin"
+    yield from g
+    yield "end"
+
+  def outer(g):
+    yield 100
+    yield from g
+
+  def first(n):
+    if n > 0:
+      yield n
+      return 0
+    yield 100
+
+s = Source()
+p = Pipeline()
+print p.evens(p.squares(s.range(0, 10)))
+print p.wrap(s.range(0, 3))
+f = p.first(3)
+print f.next(), f.has_next(), f.next()
+a = s.range(1, 4)
+o = p.outer(a)
+print o.next(), o.next(), a.next()
+print o, a.has_next()
+)"s;
+            //  a  ,  outer   ,    
+            const string expected = "0 4 16 36 64\nbegin 0 1 2 end\n3 False None\n100 1 2\n3 False\n"s;
+            {
+                istringstream input(program);
+                ostringstream output;
+                RunProgram(input, output);
+                ASSERT_EQUAL(output.str(), expected);
+            }
+            {
+                istringstream input(program);
+                parse::Lexer lexer(input);
+                auto flat_program = ParseFlatProgram(lexer);
+                ostringstream output;
+                runtime::SimpleContext context{ output };
+                runtime::Closure closure;
+                flat_program->Execute(closure, context);
+                ASSERT_EQUAL(output.str(), expected);
+            }
+            {
+                istringstream input(program);
+                ostringstream output;
+                RunLazyProgram(make_unique<parse::Lexer>(input), output);
+                ASSERT_EQUAL(output.str(), expected);
+            }
+
+            // yield from      ,    
+            //  
+            istringstream long_input(R"(
+class Source:
+  def range(i, n):
+    if i < n:
+      yield i
+      yield from self.range(i + 1, n)
+
+s = Source()
+g = s.range(0, 100000)
+print g
+)"s);
+            ostringstream long_output;
+            RunProgram(long_input, long_output);
+            string long_expected = "0"s;
+            for (int i = 1; i < 100000; ++i) {
+                long_expected += " "s + to_string(i);
+            }
+            ASSERT_EQUAL(long_output.str(), long_expected + "\n"s);
+        }
+
+        void TestGeneratorErrors() {
+            ostringstream output;
+            istringstream top_level("yield 1\n"s);
+            ASSERT_THROWS(RunProgram(top_level, output), ParseError);
+
+            istringstream not_generator(R"(
+class A:
+  def g():
+    yield from 5
+
+a = A()
+x = a.g()
+x.next()
+)"s);
+            ASSERT_THROWS(RunProgram(not_generator, output), runtime_error);
+
+            istringstream self_delegate(R"(
+class A:
+  def g():
+    yield from self
+
+a = A()
+x = a.g()
+x.next()
+)"s);
+            ASSERT_THROWS(RunProgram(self_delegate, output), runtime_error);
+        }
+
+    }  // namespace
+
+    void RunGeneratorTests(TestRunner& tr) {
+        RUN_TEST(tr, runtime::TestGenerators);
+        RUN_TEST(tr, runtime::TestGeneratorErrors);
+    }
+
+}  // namespace runtime
@@ -0,0 +1,106 @@
+#include "heap_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+        const auto INSTANCE_TYPE = "ClassInstance"sv;
+        const auto STRING_TYPE = "String"sv;
+        const auto NUMBER_TYPE = "Number"sv;
+    }  // namespace
+
+    shared_ptr<HeapProfiler::Site> HeapProfiler::GetSite(SiteKey key, string_view site_kind) {
+        auto& site = sites_[key];
+        if (!site) {
+            string name = string(key.second) + ' ';
+            if (key.second == INSTANCE_TYPE) {
+                name += site_kind;
+            }
+            else {
+                //       ,        - 
+                name += "at "s + string(site_kind);
+                name += " #"s + to_string(++node_counts_[name]);
+            }
+            site = make_shared<Site>(Site{ std::move(name), sites_.size() - 1, {} });
+        }
+        return site;
+    }
+
+    ObjectHolder HeapProfiler::Track(shared_ptr<Object> object, shared_ptr<Site> site, size_t bytes) {
+        Stats& stats = site->stats;
+        ++stats.live_count;
+        stats.live_bytes += bytes;
+        ++stats.total_count;
+        stats.total_bytes += bytes;
+        stats.peak_count = max(stats.peak_count, stats.live_count);
+        stats.peak_bytes = max(stats.peak_bytes, stats.live_bytes);
+
+        //    ,  deleter    
+        Object* raw = object.get();
+        auto deleter = [object = std::move(object), site = std::move(site), bytes](Object*) mutable {
+            --site->stats.live_count;
+            site->stats.live_bytes -= bytes;
+            object.reset();
+        };
+        return ObjectHolder(shared_ptr<Object>(raw, std::move(deleter)));
+    }
+
+    ObjectHolder HeapProfiler::Own(ClassInstance instance) {
+        const Class& cls = instance.GetClass();
+        return Track(make_shared<ClassInstance>(std::move(instance)), GetSite({ &cls, INSTANCE_TYPE }, cls.GetName()),
+            sizeof(ClassInstance));
+    }
+
+    ObjectHolder HeapProfiler::Own(String value, const void* site, string_view site_kind) {
+        const size_t bytes = sizeof(String) + (value.GetSize() > String::INLINE_CAPACITY ? value.GetSize() : 0);
+        return Track(make_shared<String>(std::move(value)), GetSite({ site, STRING_TYPE }, site_kind), bytes);
+    }
+
+    ObjectHolder HeapProfiler::Own(Number value, const void* site, string_view site_kind) {
+        return Track(make_shared<Number>(std::move(value)), GetSite({ site, NUMBER_TYPE }, site_kind),
+            sizeof(Number));
+    }
+
+    vector<pair<string, HeapProfiler::Stats>> HeapProfiler::GetStats() const {
+        vector<const Site*> sites;
+        sites.reserve(sites_.size());
+        for (const auto& [key, site] : sites_) {
+            sites.push_back(site.get());
+        }
+        sort(sites.begin(), sites.end(), [](const Site* lhs, const Site* rhs) {
+            if (lhs->stats.live_bytes != rhs->stats.live_bytes) {
+                return lhs->stats.live_bytes > rhs->stats.live_bytes;
+            }
+            return lhs->order < rhs->order;
+        });
+        vector<pair<string, Stats>> result;
+        result.reserve(sites.size());
+        for (const Site* site : sites) {
+            result.emplace_back(site->name, site->stats);
+        }
+        return result;
+    }
+
+    void HeapProfiler::Report(ostream& os) const {
+        os << "Heap profile: live count/bytes, peak count/bytes, total count/bytes\n"sv;
+        for (const auto& [name, stats] : GetStats()) {
+            os << setw(10) << stats.live_count << setw(12) << stats.live_bytes
+                << setw(10) << stats.peak_count << setw(12) << stats.peak_bytes
+                << setw(10) << stats.total_count << setw(12) << stats.total_bytes
+                << "  "sv << name << '\n';
+        }
+    }
+
+    ObjectHolder Allocate(ClassInstance instance, Context& context) {
+        if (HeapProfiler* profiler = context.GetHeapProfiler()) {
+            return profiler->Own(std::move(instance));
+        }
+        return ObjectHolder::Own(std::move(instance));
+    }
+
+}  // namespace runtime
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace runtime {
+
+    //   Mython.      ,     -
+    //   ,   .        
+    // ,  "Number at Add #2",      .
+    //    Context::GetHeapProfiler(),     ,
+    //    
+    class HeapProfiler {
+    public:
+        //      : ,   ,  
+        struct Stats {
+            size_t live_count = 0;
+            size_t live_bytes = 0;
+            size_t peak_count = 0;
+            size_t peak_bytes = 0;
+            size_t total_count = 0;
+            size_t total_bytes = 0;
+        };
+
+        //         
+        ObjectHolder Own(ClassInstance instance);
+        //  ,   site  site_kind
+        ObjectHolder Own(String value, const void* site, std::string_view site_kind);
+        ObjectHolder Own(Number value, const void* site, std::string_view site_kind);
+
+        //     ,    live_bytes,  
+        //  -    
+        [[nodiscard]] std::vector<std::pair<std::string, Stats>> GetStats() const;
+
+        //   os     
+        void Report(std::ostream& os) const;
+
+    private:
+        struct Site {
+            std::string name;
+            //       
+            size_t order;
+            Stats stats;
+        };
+
+        //     (   )   
+        using SiteKey = std::pair<const void*, std::string_view>;
+
+        std::shared_ptr<Site> GetSite(SiteKey key, std::string_view site_kind);
+        ObjectHolder Track(std::shared_ptr<Object> object, std::shared_ptr<Site> site, size_t bytes);
+
+        std::map<SiteKey, std::shared_ptr<Site>> sites_;
+        //    ,  "Number at Add",    
+        std::map<std::string, size_t> node_counts_;
+    };
+
+    // ,      base
+    class ProfilingContext : public Context {
+    public:
+        //         base   
+        explicit ProfilingContext(Context& base)
+            : base_(base) {
+            SetExecutionBudget(base.GetExecutionBudget());
+            SetMaxCallDepth(base.GetMaxCallDepth());
+        }
+
+        std::ostream& GetOutputStream() override {
+            return base_.GetOutputStream();
+        }
+
+        HeapProfiler* GetHeapProfiler() override {
+            return &profiler_;
+        }
+
+        TaskScheduler* GetTaskScheduler() override {
+            return base_.GetTaskScheduler();
+        }
+
+    private:
+        Context& base_;
+        HeapProfiler profiler_;
+    };
+
+    //  value  .    ,    
+    //  site  site_kind.    -   
+    template <typename T>
+    ObjectHolder Allocate(T&& value, Context& context, const void* site, std::string_view site_kind) {
+        if (HeapProfiler* profiler = context.GetHeapProfiler()) {
+            return profiler->Own(std::forward<T>(value), site, site_kind);
+        }
+        return ObjectHolder::Own(std::forward<T>(value));
+    }
+
+    //   ,     ,    
+    ObjectHolder Allocate(ClassInstance instance, Context& context);
+
+}  // namespace runtime
@@ -0,0 +1,259 @@
+#include "incremental_program.h"
+
+#include "lexer.h"
+#include "parse.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+namespace parse {
+
+    namespace {
+        constexpr size_t NOT_REUSED = numeric_limits<size_t>::max();
+
+        //     npos,       
+        size_t GetIndent(string_view line) {
+            const size_t indent = line.find_first_not_of(' ');
+            if (indent == string_view::npos || line[indent] == '#' || line[indent] == '\n' || line[indent] == '\r') {
+                return string_view::npos;
+            }
+            return indent;
+        }
+
+        bool StartsWithWord(string_view line, string_view word) {
+            return line.substr(0, word.size()) == word
+                && (line.size() == word.size() || (!isalnum(static_cast<unsigned char>(line[word.size()]))
+                    && line[word.size()] != '_'));
+        }
+
+        //  action    text     
+        template <typename Action>
+        void ForEachLine(string_view text, Action action) {
+            for (size_t begin = 0; begin < text.size();) {
+                const size_t end = min(text.find('\n', begin), text.size() - 1) + 1;
+                action(text.substr(begin, end - begin), begin);
+                begin = end;
+            }
+        }
+
+        //   classes ,   unit
+        template <typename Unit>
+        void AddClasses(const Unit& unit, KnownClasses& classes) {
+            for (const runtime::ObjectHolder& holder : unit.classes) {
+                const auto* cls = holder.TryAs<runtime::Class>();
+                classes.emplace(cls->GetName(), cls);
+            }
+        }
+    }  // namespace
+
+    IncrementalProgram::IncrementalProgram(std::string source)
+        : source_(std::move(source))
+        , units_(Split(source_)) {
+        ParseAll(units_);
+    }
+
+    vector<IncrementalProgram::Unit> IncrementalProgram::Split(string_view text) {
+        //   ,  else,  .    
+        //    
+        vector<Unit> units;
+        size_t unit_begin = string_view::npos;
+        auto add_unit = [&](size_t end) {
+            if (unit_begin != string_view::npos) {
+                units.emplace_back();
+                units.back().text = text.substr(unit_begin, end - unit_begin);
+            }
+        };
+        ForEachLine(text, [&](string_view line, size_t begin) {
+            if (GetIndent(line) == 0 && !StartsWithWord(line, "else"sv)) {
+                add_unit(begin);
+                unit_begin = begin;
+            }
+        });
+        add_unit(text.size());
+
+        //           
+        for (Unit& unit : units) {
+            if (!StartsWithWord(unit.text, "class"sv)) {
+                continue;
+            }
+            size_t body_indent = string_view::npos;
+            ForEachLine(unit.text, [&](string_view line, size_t begin) {
+                if (begin == 0) {
+                    unit.class_header = line;
+                    return;
+                }
+                const size_t indent = GetIndent(line);
+                if (body_indent == string_view::npos) {
+                    body_indent = indent;
+                }
+                if (indent == body_indent && body_indent != string_view::npos) {
+                    unit.methods.emplace_back();
+                }
+                if (!unit.methods.empty()) {
+                    line.remove_prefix(min(line.find_first_not_of(' '), min(body_indent, line.size())));
+                    unit.methods.back() += line;
+                }
+            });
+        }
+        return units;
+    }
+
+    void IncrementalProgram::ParseUnit(Unit& unit, const KnownClasses& classes) {
+        istringstream input(unit.text);
+        Lexer lexer(input);
+        unit.classes.clear();
+        unit.program = ParseProgramWithClasses(lexer, classes, &unit.classes);
+    }
+
+    void IncrementalProgram::ParseAll(vector<Unit>& units) {
+        KnownClasses classes;
+        for (Unit& unit : units) {
+            ParseUnit(unit, classes);
+            AddClasses(unit, classes);
+        }
+    }
+
+    IncrementalProgram::UpdateStats IncrementalProgram::Update(std::string source) {
+        vector<Unit> units = Split(source);
+        const size_t common = min(units_.size(), units.size());
+        size_t prefix = 0;
+        while (prefix < common && units_[prefix].text == units[prefix].text) {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < common - prefix
+            && units_[units_.size() - 1 - suffix].text == units[units.size() - 1 - suffix].text) {
+            ++suffix;
+        }
+
+        UpdateStats stats;
+        if (!TryUpdate(units, prefix, suffix, stats)) {
+            ParseAll(units);
+            stats = UpdateStats{ 0, 0, true };
+            for (Unit& unit : units_) {
+                if (!unit.classes.empty()) {
+                    retired_.push_back(std::move(unit));
+                }
+            }
+            units_ = std::move(units);
+        }
+        source_ = std::move(source);
+        return stats;
+    }
+
+    bool IncrementalProgram::TryUpdate(vector<Unit>& units, size_t prefix, size_t suffix, UpdateStats& stats) {
+        const size_t old_end = units_.size() - suffix;
+        const size_t new_end = units.size() - suffix;
+
+        //      ,    
+        //         
+        for (size_t i = prefix; i < max(old_end, new_end); ++i) {
+            const bool old_class = i < old_end && units_[i].IsClass();
+            const bool new_class = i < new_end && units[i].IsClass();
+            if ((i < old_end && units_[i].IsOpaque()) || ((old_class || new_class)
+                && (old_end != new_end || !old_class || !new_class || units_[i].class_header != units[i].class_header))) {
+                return false;
+            }
+        }
+
+        //   .        
+        struct ClassEdit {
+            size_t index;
+            vector<runtime::Method> methods;
+            vector<size_t> reused;
+        };
+        vector<ClassEdit> class_edits;
+
+        KnownClasses classes;
+        for (size_t i = 0; i < prefix; ++i) {
+            AddClasses(units_[i], classes);
+        }
+        for (size_t i = prefix; i < new_end; ++i) {
+            Unit& unit = units[i];
+            if (!unit.IsClass()) {
+                ParseUnit(unit, classes);
+                if (unit.IsOpaque()) {
+                    return false;
+                }
+                ++stats.statements;
+                continue;
+            }
+
+            const Unit& old_unit = units_[i];
+            unordered_multimap<string_view, size_t> old_methods;
+            for (size_t j = 0; j < old_unit.methods.size(); ++j) {
+                old_methods.emplace(old_unit.methods[j], j);
+            }
+            ClassEdit edit{ i, {}, {} };
+            for (const string& text : unit.methods) {
+                if (const auto it = old_methods.find(text); it != old_methods.end()) {
+                    edit.reused.push_back(it->second);
+                    edit.methods.emplace_back();
+                    old_methods.erase(it);
+                    continue;
+                }
+                istringstream input(text);
+                Lexer lexer(input);
+                vector<runtime::ObjectHolder> nested_classes;
+                edit.methods.push_back(ParseMethod(lexer, classes, &nested_classes));
+                if (!nested_classes.empty()) {
+                    return false;
+                }
+                edit.reused.push_back(NOT_REUSED);
+                ++stats.methods;
+            }
+            class_edits.push_back(std::move(edit));
+            AddClasses(old_unit, classes);
+        }
+
+        size_t replaced_methods = 0;
+        for (const ClassEdit& edit : class_edits) {
+            replaced_methods += units_[edit.index].classes.front().TryAs<runtime::Class>()->methods_.size();
+        }
+        retired_methods_.reserve(retired_methods_.size() + replaced_methods);
+
+        //  ,     
+        for (ClassEdit& edit : class_edits) {
+            Unit& old_unit = units_[edit.index];
+            auto* cls = old_unit.classes.front().TryAs<runtime::Class>();
+            for (size_t j = 0; j < edit.methods.size(); ++j) {
+                if (edit.reused[j] != NOT_REUSED) {
+                    edit.methods[j] = std::move(cls->methods_[edit.reused[j]]);
+                }
+            }
+            for (runtime::Method& method : cls->methods_) {
+                if (method.body && method.is_generator) {
+                    retired_methods_.push_back(std::move(method));
+                }
+            }
+            cls->methods_ = std::move(edit.methods);
+            units[edit.index].program = std::move(old_unit.program);
+            units[edit.index].classes = std::move(old_unit.classes);
+        }
+        for (size_t i = 0; i < prefix; ++i) {
+            units[i].program = std::move(units_[i].program);
+            units[i].classes = std::move(units_[i].classes);
+        }
+        for (size_t i = 0; i < suffix; ++i) {
+            Unit& old_unit = units_[units_.size() - 1 - i];
+            units[units.size() - 1 - i].program = std::move(old_unit.program);
+            units[units.size() - 1 - i].classes = std::move(old_unit.classes);
+        }
+        units_ = std::move(units);
+        return true;
+    }
+
+    runtime::ObjectHolder IncrementalProgram::Execute(runtime::Closure& closure, runtime::Context& context) const {
+        for (const Unit& unit : units_) {
+            unit.program->Execute(closure, context);
+        }
+        return runtime::ObjectHolder::None();
+    }
+
+}  // namespace parse
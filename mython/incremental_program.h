@@ -0,0 +1,88 @@
+#pragma once
+
+#include "parse.h"
+#include "runtime.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace parse {
+
+    // ,          .
+    //       -       
+    // , -       .    Method 
+    //  runtime::Class,        
+    // .  ,    ,   .
+    // ,    ,  ,    
+    //  ,    ,     
+    class IncrementalProgram : public runtime::Executable {
+    public:
+        //       
+        struct UpdateStats {
+            //    ,   
+            size_t statements = 0;
+            size_t methods = 0;
+            //   
+            bool full = false;
+        };
+
+        //   .   - ParseError  parse::LexerError
+        explicit IncrementalProgram(std::string source);
+
+        //     source,     .  
+        //       .
+        //       
+        UpdateStats Update(std::string source);
+
+        //      
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+
+        [[nodiscard]] const std::string& GetSource() const {
+            return source_;
+        }
+
+    private:
+        //   
+        struct Unit {
+            std::string text;
+            //    -         
+            std::string class_header;
+            std::vector<std::string> methods;
+            std::unique_ptr<runtime::Executable> program;
+            //   
+            std::vector<runtime::ObjectHolder> classes;
+
+            [[nodiscard]] bool IsClass() const {
+                return !class_header.empty();
+            }
+            //     :   ,   
+            //   ,      
+            [[nodiscard]] bool IsOpaque() const {
+                return IsClass() ? classes.size() != 1 : !classes.empty();
+            }
+        };
+
+        //  text  ,   
+        static std::vector<Unit> Split(std::string_view text);
+        //  ,    classes
+        static void ParseUnit(Unit& unit, const KnownClasses& classes);
+        //    units 
+        static void ParseAll(std::vector<Unit>& units);
+        //   units       :  units
+        //  units_   prefix   suffix .  false, 
+        //  ,        
+        bool TryUpdate(std::vector<Unit>& units, size_t prefix, size_t suffix, UpdateStats& stats);
+
+        std::string source_;
+        std::vector<Unit> units_;
+        // ,     .    
+        //     ,      
+        std::vector<Unit> retired_;
+        // -,   .    
+        //  ,      
+        std::vector<runtime::Method> retired_methods_;
+    };
+
+}  // namespace parse
@@ -0,0 +1,378 @@
+#include "lane_eval.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace flat_ast {
+
+    using runtime::ObjectHolder;
+
+    namespace {
+        // ,     :    
+        struct Unsupported {};
+
+        constexpr uint64_t Lane(size_t i) {
+            return uint64_t{ 1 } << i;
+        }
+
+        //  ,   pred(values[i])
+        template <typename Values, typename Predicate>
+        uint64_t MaskOf(const Values& values, Predicate pred) {
+            uint64_t mask = 0;
+            for (size_t i = 0; i < values.size(); ++i) {
+                mask |= static_cast<uint64_t>(pred(values[i]) ? 1 : 0) << i;
+            }
+            return mask;
+        }
+    }  // namespace
+
+    LaneEvaluator::LaneEvaluator(ObjectHolder self, const std::string& method)
+        : self_(std::move(self))
+        , method_(method) {
+        const auto* instance = self_.TryAs<runtime::ClassInstance>();
+        const runtime::Method* m = instance ? instance->GetClass().GetMethod(method) : nullptr;
+        if (!m) {
+            throw runtime_error("Object has no method "s + method);
+        }
+        const auto* body = dynamic_cast<const MethodBody*>(m->body.get());
+        //       ast    
+        if (!body || m->is_generator) {
+            return;
+        }
+        tree_ = body->GetTree().shared_from_this();
+        body_ = body->GetBody();
+        for (const string& param : m->formal_params) {
+            params_.push_back(FindName(param));
+        }
+        self_name_ = FindName("self"s);
+    }
+
+    std::vector<ObjectHolder> LaneEvaluator::Evaluate(const std::vector<std::vector<ObjectHolder>>& inputs,
+        runtime::Context& context) {
+        vector<ObjectHolder> results(inputs.size());
+        for (size_t first = 0; first < inputs.size(); first += LANES) {
+            const size_t count = min(LANES, inputs.size() - first);
+            if (tree_ && TryEvaluateGroup(inputs, first, count, results)) {
+                stats_.vector_lanes += count;
+                continue;
+            }
+            auto* instance = self_.TryAs<runtime::ClassInstance>();
+            for (size_t i = first; i < first + count; ++i) {
+                results[i] = instance->Call(method_, inputs[i], context);
+            }
+            stats_.scalar_lanes += count;
+        }
+        return results;
+    }
+
+    bool LaneEvaluator::TryEvaluateGroup(const std::vector<std::vector<ObjectHolder>>& inputs, size_t first,
+        size_t count, std::vector<ObjectHolder>& results) {
+        const uint64_t all = count == LANES ? ~uint64_t{ 0 } : Lane(count) - 1;
+        Group group;
+        for (size_t p = 0; p < params_.size(); ++p) {
+            Variable variable;
+            for (size_t i = 0; i < count; ++i) {
+                const vector<ObjectHolder>& args = inputs[first + i];
+                if (args.size() != params_.size()) {
+                    return false;
+                }
+                Kind kind;
+                if (const auto* number = args[p].TryAs<runtime::Number>()) {
+                    kind = Kind::Int;
+                    variable.value.values[i] = number->GetValue();
+                }
+                else if (const auto* flag = args[p].TryAs<runtime::Bool>()) {
+                    kind = Kind::Bool;
+                    variable.value.values[i] = flag->GetValue() ? 1 : 0;
+                }
+                else {
+                    return false;
+                }
+                if (i > 0 && kind != variable.value.kind) {
+                    return false;
+                }
+                variable.value.kind = kind;
+            }
+            variable.defined = all;
+            if (params_[p] != NO_NODE) {
+                group.variables[params_[p]] = variable;
+            }
+        }
+
+        try {
+            uint64_t active = all;
+            Exec(body_, active, group);
+            // ,      return,  None
+            for (size_t i = 0; i < count; ++i) {
+                if (active & Lane(i)) {
+                    group.result_kinds[i] = Kind::None;
+                }
+            }
+        }
+        catch (const Unsupported&) {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const int32_t value = group.result.values[i];
+            switch (group.result_kinds[i]) {
+            case Kind::Int:
+                results[first + i] = ObjectHolder::Own(runtime::Number(value));
+                break;
+            case Kind::Bool:
+                results[first + i] = ObjectHolder::Own(runtime::Bool(value != 0));
+                break;
+            case Kind::None:
+                results[first + i] = ObjectHolder::None();
+                break;
+            }
+        }
+        return true;
+    }
+
+    void LaneEvaluator::Exec(NodeIndex index, uint64_t& active, Group& group) const {
+        if (active == 0) {
+            return;
+        }
+        const Node& node = tree_->nodes_[index];
+        switch (node.kind) {
+        case NodeKind::Compound:
+            for (uint32_t i = node.items; i < node.items + node.count && active != 0; ++i) {
+                Exec(tree_->lists_[i], active, group);
+            }
+            return;
+        case NodeKind::IfElse: {
+            const Lanes condition = Eval(node.arg[0], active, group);
+            uint64_t then_lanes = active & MaskOf(condition.values, [](int32_t value) {
+                return value != 0;
+            });
+            uint64_t else_lanes = active & ~then_lanes;
+            Exec(node.arg[1], then_lanes, group);
+            if (node.arg[2] != NO_NODE) {
+                Exec(node.arg[2], else_lanes, group);
+            }
+            active = then_lanes | else_lanes;
+            return;
+        }
+        case NodeKind::Assignment: {
+            const Lanes value = Eval(node.arg[1], active, group);
+            auto [it, inserted] = group.variables.try_emplace(node.arg[0]);
+            Variable& variable = it->second;
+            //        
+            if (!inserted && variable.defined != 0 && variable.value.kind != value.kind
+                && (variable.defined & ~active) != 0) {
+                throw Unsupported{};
+            }
+            variable.value.kind = value.kind;
+            for (size_t i = 0; i < LANES; ++i) {
+                if (active & Lane(i)) {
+                    variable.value.values[i] = value.values[i];
+                }
+            }
+            variable.defined |= active;
+            return;
+        }
+        case NodeKind::Return: {
+            const Lanes value = tree_->nodes_[node.arg[0]].kind == NodeKind::None
+                ? Lanes{ Kind::None, {} }
+                : Eval(node.arg[0], active, group);
+            for (size_t i = 0; i < LANES; ++i) {
+                if (active & Lane(i)) {
+                    group.result.values[i] = value.values[i];
+                    group.result_kinds[i] = value.kind;
+                }
+            }
+            active = 0;
+            return;
+        }
+        default:
+            //    :   ,    
+            Eval(index, active, group);
+        }
+    }
+
+    LaneEvaluator::Lanes LaneEvaluator::Eval(NodeIndex index, uint64_t active, Group& group) const {
+        const Node& node = tree_->nodes_[index];
+        Lanes result;
+        switch (node.kind) {
+        case NodeKind::NumericConst:
+            result.values.fill(tree_->numbers_[node.arg[0]].GetValue());
+            return result;
+        case NodeKind::BoolConst:
+            result.kind = Kind::Bool;
+            result.values.fill(node.op ? 1 : 0);
+            return result;
+        case NodeKind::VariableValue:
+            return EvalVariable(node, active, group);
+        case NodeKind::Add:
+        case NodeKind::Sub:
+        case NodeKind::Mult:
+        case NodeKind::Div: {
+            const Lanes lhs = Eval(node.arg[0], active, group);
+            const Lanes rhs = Eval(node.arg[1], active, group);
+            if (lhs.kind != Kind::Int || rhs.kind != Kind::Int) {
+                throw Unsupported{};
+            }
+            const auto& a = lhs.values;
+            const auto& b = rhs.values;
+            auto& r = result.values;
+            //     2^32,   int   
+            switch (node.kind) {
+            case NodeKind::Add:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = static_cast<int32_t>(static_cast<uint32_t>(a[i]) + static_cast<uint32_t>(b[i]));
+                }
+                break;
+            case NodeKind::Sub:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = static_cast<int32_t>(static_cast<uint32_t>(a[i]) - static_cast<uint32_t>(b[i]));
+                }
+                break;
+            case NodeKind::Mult:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = static_cast<int32_t>(static_cast<uint32_t>(a[i]) * static_cast<uint32_t>(b[i]));
+                }
+                break;
+            default:
+                //           
+                if ((active & MaskOf(b, [](int32_t value) { return value == 0; })) != 0) {
+                    throw Unsupported{};
+                }
+                for (size_t i = 0; i < LANES; ++i) {
+                    //      ,  INT_MIN / -1    int
+                    r[i] = b[i] == -1 ? static_cast<int32_t>(0u - static_cast<uint32_t>(a[i]))
+                                      : a[i] / (b[i] == 0 ? 1 : b[i]);
+                }
+            }
+            return result;
+        }
+        case NodeKind::Comparison: {
+            const Lanes lhs = Eval(node.arg[0], active, group);
+            const Lanes rhs = Eval(node.arg[1], active, group);
+            if (lhs.kind != rhs.kind) {
+                throw Unsupported{};
+            }
+            const auto& a = lhs.values;
+            const auto& b = rhs.values;
+            auto& r = result.values;
+            result.kind = Kind::Bool;
+            //      COMPARATORS  flat_ast.cpp
+            switch (node.op) {
+            case 0:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] == b[i];
+                }
+                break;
+            case 1:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] != b[i];
+                }
+                break;
+            case 2:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] < b[i];
+                }
+                break;
+            case 3:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] > b[i];
+                }
+                break;
+            case 4:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] <= b[i];
+                }
+                break;
+            default:
+                for (size_t i = 0; i < LANES; ++i) {
+                    r[i] = a[i] >= b[i];
+                }
+            }
+            return result;
+        }
+        case NodeKind::Not: {
+            const Lanes argument = Eval(node.arg[0], active, group);
+            if (argument.kind != Kind::Bool) {
+                throw Unsupported{};
+            }
+            result.kind = Kind::Bool;
+            for (size_t i = 0; i < LANES; ++i) {
+                result.values[i] = argument.values[i] == 0;
+            }
+            return result;
+        }
+        case NodeKind::And:
+        case NodeKind::Or: {
+            //      ,     
+            const Lanes lhs = Eval(node.arg[0], active, group);
+            if (lhs.kind != Kind::Bool) {
+                throw Unsupported{};
+            }
+            const bool is_and = node.kind == NodeKind::And;
+            const uint64_t rhs_lanes = active & MaskOf(lhs.values, [is_and](int32_t value) {
+                return (value != 0) == is_and;
+            });
+            result = lhs;
+            if (rhs_lanes != 0) {
+                const Lanes rhs = Eval(node.arg[1], rhs_lanes, group);
+                if (rhs.kind != Kind::Bool) {
+                    throw Unsupported{};
+                }
+                for (size_t i = 0; i < LANES; ++i) {
+                    if (rhs_lanes & Lane(i)) {
+                        result.values[i] = rhs.values[i];
+                    }
+                }
+            }
+            return result;
+        }
+        default:
+            throw Unsupported{};
+        }
+    }
+
+    LaneEvaluator::Lanes LaneEvaluator::EvalVariable(const Node& node, uint64_t active, Group& group) const {
+        const uint32_t name = tree_->lists_[node.items];
+        if (const auto it = group.variables.find(name); it != group.variables.end()) {
+            //           
+            if (node.count != 1 || (active & ~it->second.defined) != 0) {
+                throw Unsupported{};
+            }
+            return it->second.value;
+        }
+        if (name != self_name_ || node.count < 2) {
+            throw Unsupported{};
+        }
+
+        //  self    ,      
+        runtime::Closure closure{ { "self"s, self_ } };
+        ObjectHolder value;
+        try {
+            value = tree_->ExecuteVariableValue(node, closure);
+        }
+        catch (const runtime_error&) {
+            throw Unsupported{};
+        }
+        Lanes result;
+        if (const auto* number = value.TryAs<runtime::Number>()) {
+            result.values.fill(number->GetValue());
+        }
+        else if (const auto* flag = value.TryAs<runtime::Bool>()) {
+            result.kind = Kind::Bool;
+            result.values.fill(flag->GetValue() ? 1 : 0);
+        }
+        else {
+            throw Unsupported{};
+        }
+        return result;
+    }
+
+    uint32_t LaneEvaluator::FindName(const std::string& name) const {
+        const auto it = find(tree_->names_.begin(), tree_->names_.end(), name);
+        return it == tree_->names_.end() ? NO_NODE : static_cast<uint32_t>(it - tree_->names_.begin());
+    }
+
+}  // namespace flat_ast
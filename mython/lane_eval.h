@@ -0,0 +1,94 @@
+#pragma once
+
+#include "flat_ast.h"
+#include "runtime.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flat_ast {
+
+    //        .    
+    //  LANES ,           :  
+    //      ,    if 
+    //    .   ,   : ,
+    //     self     , ,
+    // ,  , if/else  return.     -  -
+    // , ,  , print,   , -    
+    //  ,        
+    class LaneEvaluator {
+    public:
+        static constexpr size_t LANES = 64;
+
+        struct Stats {
+            // ,       
+            size_t vector_lanes = 0;
+            size_t scalar_lanes = 0;
+        };
+
+        //     method  runtime_error
+        LaneEvaluator(runtime::ObjectHolder self, const std::string& method);
+
+        //     inputs[i]   i     .
+        //      ,    
+        std::vector<runtime::ObjectHolder> Evaluate(const std::vector<std::vector<runtime::ObjectHolder>>& inputs,
+            runtime::Context& context);
+
+        [[nodiscard]] const Stats& GetStats() const {
+            return stats_;
+        }
+
+    private:
+        enum class Kind : uint8_t {
+            Int,
+            Bool,
+            None,
+        };
+
+        //      
+        struct Lanes {
+            Kind kind = Kind::Int;
+            alignas(32) std::array<int32_t, LANES> values{};
+        };
+
+        struct Variable {
+            Lanes value;
+            // ,     
+            uint64_t defined = 0;
+        };
+
+        //    
+        struct Group {
+            std::unordered_map<uint32_t, Variable> variables;
+            Lanes result;
+            std::array<Kind, LANES> result_kinds{};
+        };
+
+        //   inputs[first, first + count)  .  false,  
+        //      
+        bool TryEvaluateGroup(const std::vector<std::vector<runtime::ObjectHolder>>& inputs, size_t first,
+            size_t count, std::vector<runtime::ObjectHolder>& results);
+        Lanes Eval(NodeIndex index, uint64_t active, Group& group) const;
+        //  . ,  return,   active
+        void Exec(NodeIndex index, uint64_t& active, Group& group) const;
+        Lanes EvalVariable(const Node& node, uint64_t active, Group& group) const;
+        //      NO_NODE,      
+        [[nodiscard]] uint32_t FindName(const std::string& name) const;
+
+        runtime::ObjectHolder self_;
+        std::string method_;
+        //    ,      
+        std::shared_ptr<const Tree> tree_;
+        NodeIndex body_ = NO_NODE;
+        //      self
+        std::vector<uint32_t> params_;
+        uint32_t self_name_ = NO_NODE;
+        Stats stats_;
+    };
+
+}  // namespace flat_ast
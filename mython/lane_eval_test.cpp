@@ -0,0 +1,94 @@
+#include "lane_eval.h"
+#include "mython.h"
+#include "test_runner_p.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace flat_ast {
+
+    namespace {
+
+        void TestLaneEvaluator() {
+            const string source = R"(
+class Scorer:
+  def __init__(bonus):
+    self.bonus = bonus
+
+  def score(age, income, flag):
+    base = income / 10
+    if age < 18:
+      return 0
+    if flag and income > 500:
+      base = base + self.bonus
+    if age > 60:
+      base = base * 2 - age
+    else:
+      if not flag:
+        return base - 1
+    return base
+
+  def ratio(a, b):
+    return a / b
+
+  def label(a):
+    if a > 0:
+      return "positive"
+    return a
+
+scorer = Scorer(7)
+)"s;
+            const mython::CompiledProgram program = mython::Compile(source);
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            const runtime::Closure globals = mython::Run(program, context);
+            const runtime::ObjectHolder scorer = globals.at("scorer"s);
+            auto* instance = scorer.TryAs<runtime::ClassInstance>();
+
+            //       ,      
+            vector<vector<runtime::ObjectHolder>> inputs;
+            for (int i = 0; i < 150; ++i) {
+                inputs.push_back({ runtime::ObjectHolder::Own(runtime::Number(i % 90)),
+                    runtime::ObjectHolder::Own(runtime::Number(i * 37 % 1000)),
+                    runtime::ObjectHolder::Own(runtime::Bool(i % 3 == 0)) });
+            }
+            flat_ast::LaneEvaluator evaluator(scorer, "score"s);
+            const vector<runtime::ObjectHolder> results = evaluator.Evaluate(inputs, context);
+            ASSERT_EQUAL(results.size(), inputs.size());
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                const runtime::ObjectHolder expected = instance->Call("score"s, inputs[i], context);
+                ASSERT_EQUAL(results[i].TryAs<runtime::Number>()->GetValue(), expected.TryAs<runtime::Number>()->GetValue());
+            }
+            ASSERT_EQUAL(evaluator.GetStats().vector_lanes, 150u);
+            ASSERT_EQUAL(evaluator.GetStats().scalar_lanes, 0u);
+
+            //      
+            vector<vector<runtime::ObjectHolder>> mixed = { { runtime::ObjectHolder::Own(runtime::Number(5)) },
+                { runtime::ObjectHolder::Own(runtime::Number(-5)) } };
+            flat_ast::LaneEvaluator labels(scorer, "label"s);
+            const vector<runtime::ObjectHolder> label_results = labels.Evaluate(mixed, context);
+            ASSERT_EQUAL(label_results[0].TryAs<runtime::String>()->GetValue(), "positive"s);
+            ASSERT_EQUAL(label_results[1].TryAs<runtime::Number>()->GetValue(), -5);
+            ASSERT_EQUAL(labels.GetStats().scalar_lanes, 2u);
+
+            //          ,    
+            flat_ast::LaneEvaluator ratios(scorer, "ratio"s);
+            vector<vector<runtime::ObjectHolder>> divisions = { { runtime::ObjectHolder::Own(runtime::Number(6)),
+                runtime::ObjectHolder::Own(runtime::Number(3)) } };
+            ASSERT_EQUAL(ratios.Evaluate(divisions, context)[0].TryAs<runtime::Number>()->GetValue(), 2);
+            divisions.push_back({ runtime::ObjectHolder::Own(runtime::Number(1)), runtime::ObjectHolder::Own(runtime::Number(0)) });
+            ASSERT_THROWS(ratios.Evaluate(divisions, context), runtime_error);
+
+            ASSERT_THROWS(flat_ast::LaneEvaluator(scorer, "missing"s), runtime_error);
+        }
+
+    }  // namespace
+
+    void RunLaneEvaluatorTests(TestRunner& tr) {
+        RUN_TEST(tr, flat_ast::TestLaneEvaluator);
+    }
+
+}  // namespace flat_ast
@@ -1,9 +1,20 @@
 #include "lexer.h"
 
+#include "lexer_scan.h"
+#include "mapped_file.h"
+
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <charconv>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <system_error>
+#include <thread>
 #include <unordered_map>
 #include <string>
+#include <utility>
 
 using namespace std;
 
@@ -69,6 +80,8 @@ namespace parse {
         UNVALUED_OUTPUT(None);
         UNVALUED_OUTPUT(True);
         UNVALUED_OUTPUT(False);
+        UNVALUED_OUTPUT(Spawn);
+        UNVALUED_OUTPUT(Yield);
         UNVALUED_OUTPUT(Eof);
 
 #undef UNVALUED_OUTPUT
@@ -76,228 +89,592 @@ namespace parse {
         return os << "Unknown token :("sv;
     }
 
-    void Lexer::ParseOP(std::string& line, size_t& i) {
-        using namespace token_type;
-        if (line[i] == '=' && i + 1 < line.size() && line[i + 1] == '=') {
-            lexem_.emplace_back(Eq());
-            ++i;
-            return;
+    namespace {
+        //   T  TokenBase
+        template <typename T, typename Variant>
+        struct KindOf;
+
+        template <typename T, typename... Types>
+        struct KindOf<T, std::variant<Types...>> {
+            static constexpr uint8_t Find() {
+                constexpr bool matches[] = { std::is_same_v<T, Types>... };
+                for (uint8_t i = 0; i < sizeof...(Types); ++i) {
+                    if (matches[i]) {
+                        return i;
+                    }
+                }
+                return sizeof...(Types);
+            }
+
+            static constexpr uint8_t value = Find();
+        };
+
+        template <typename T>
+        constexpr uint8_t KIND = KindOf<T, TokenBase>::value;
+
+        //   ,     
+        template <size_t... Kinds>
+        std::array<Token, sizeof...(Kinds)> MakeUnvaluedTokens(std::index_sequence<Kinds...>) {
+            return { Token(std::in_place_index<Kinds>)... };
         }
-        if (line[i] == '>' && i + 1 < line.size() && line[i + 1] == '=') {
-            lexem_.emplace_back(GreaterOrEq());
-            ++i;
-            return;
+
+        const std::array<Token, std::variant_size_v<TokenBase>> UNVALUED_TOKENS
+            = MakeUnvaluedTokens(std::make_index_sequence<std::variant_size_v<TokenBase>>());
+
+        //   ,      TokenBase
+        constexpr uint8_t NO_KIND = std::variant_size_v<TokenBase>;
+
+        //       ,  payload -  
+        constexpr uint8_t INDENT_MARK = NO_KIND + 1;
+
+        //  text      chunk_size,   
+        std::vector<std::string_view> SplitLines(std::string_view text, size_t chunk_size) {
+            std::vector<std::string_view> chunks;
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t end = text.find('\n', pos + std::max<size_t>(chunk_size, 1) - 1);
+                end = end == std::string_view::npos ? text.size() : end + 1;
+                chunks.push_back(text.substr(pos, end - pos));
+                pos = end;
+            }
+            return chunks;
         }
-        if (line[i] == '<' && i + 1 < line.size() && line[i + 1] == '=') {
-            lexem_.emplace_back(LessOrEq());
-            ++i;
+
+        //   ,     
+        enum class CharClass : uint8_t {
+            Other,     //   token_type::Char
+            Blank,     //   
+            Digit,
+            Letter,    //     
+            Quote,     //   
+            Comment,
+            Operator,  //    
+        };
+
+        constexpr std::array<CharClass, 256> MakeCharClasses() {
+            std::array<CharClass, 256> classes{};
+            classes[' '] = classes['\t'] = CharClass::Blank;
+            for (char c = '0'; c <= '9'; ++c) {
+                classes[static_cast<unsigned char>(c)] = CharClass::Digit;
+            }
+            for (char c = 'a'; c <= 'z'; ++c) {
+                classes[static_cast<unsigned char>(c)] = CharClass::Letter;
+                classes[static_cast<unsigned char>(c - 'a' + 'A')] = CharClass::Letter;
+            }
+            classes['_'] = CharClass::Letter;
+            classes['\''] = classes['"'] = CharClass::Quote;
+            classes['#'] = CharClass::Comment;
+            classes['='] = classes['<'] = classes['>'] = classes['!'] = CharClass::Operator;
+            return classes;
+        }
+
+        constexpr std::array<CharClass, 256> CHAR_CLASSES = MakeCharClasses();
+
+        constexpr CharClass GetCharClass(char c) {
+            return CHAR_CLASSES[static_cast<unsigned char>(c)];
+        }
+
+        //   ,    - ,   - '='
+        constexpr std::array<uint8_t, 256> MakeComparisonKinds() {
+            std::array<uint8_t, 256> kinds{};
+            for (auto& kind : kinds) {
+                kind = NO_KIND;
+            }
+            kinds['='] = KIND<token_type::Eq>;
+            kinds['!'] = KIND<token_type::NotEq>;
+            kinds['<'] = KIND<token_type::LessOrEq>;
+            kinds['>'] = KIND<token_type::GreaterOrEq>;
+            return kinds;
+        }
+
+        constexpr std::array<uint8_t, 256> COMPARISON_KINDS = MakeComparisonKinds();
+
+        struct Keyword {
+            std::string_view text;
+            uint8_t kind = NO_KIND;
+        };
+
+        constexpr Keyword KEYWORDS[] = {
+            { "class"sv, KIND<token_type::Class> },
+            { "return"sv, KIND<token_type::Return> },
+            { "if"sv, KIND<token_type::If> },
+            { "else"sv, KIND<token_type::Else> },
+            { "def"sv, KIND<token_type::Def> },
+            { "print"sv, KIND<token_type::Print> },
+            { "and"sv, KIND<token_type::And> },
+            { "or"sv, KIND<token_type::Or> },
+            { "not"sv, KIND<token_type::Not> },
+            { "None"sv, KIND<token_type::None> },
+            { "True"sv, KIND<token_type::True> },
+            { "False"sv, KIND<token_type::False> },
+            { "spawn"sv, KIND<token_type::Spawn> },
+            { "yield"sv, KIND<token_type::Yield> },
+        };
+
+        constexpr size_t KEYWORD_TABLE_SIZE = 64;
+
+        //  -  KEYWORDS:       
+        //    .    ,    
+        // return  spawn.  text  
+        constexpr size_t KeywordHash(std::string_view text) {
+            return (static_cast<unsigned char>(text.front()) + static_cast<unsigned char>(text.back()) + 2 * text.size())
+                % KEYWORD_TABLE_SIZE;
+        }
+
+        constexpr bool IsPerfectKeywordHash() {
+            bool used[KEYWORD_TABLE_SIZE] = {};
+            for (const Keyword& keyword : KEYWORDS) {
+                if (used[KeywordHash(keyword.text)]) {
+                    return false;
+                }
+                used[KeywordHash(keyword.text)] = true;
+            }
+            return true;
+        }
+
+        static_assert(IsPerfectKeywordHash(), "Keyword hash must not have collisions");
+
+        constexpr std::array<Keyword, KEYWORD_TABLE_SIZE> MakeKeywordTable() {
+            std::array<Keyword, KEYWORD_TABLE_SIZE> table{};
+            for (const Keyword& keyword : KEYWORDS) {
+                table[KeywordHash(keyword.text)] = keyword;
+            }
+            return table;
+        }
+
+        constexpr std::array<Keyword, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = MakeKeywordTable();
+    }  // namespace
+
+    template <typename T>
+    void Lexer::Emit() {
+        lexem_.push_back({ KIND<T> });
+    }
+
+    void Lexer::EmitNumber(int value) {
+        lexem_.push_back({ KIND<token_type::Number>, false, static_cast<uint32_t>(value) });
+    }
+
+    void Lexer::EmitChar(char value) {
+        lexem_.push_back({ KIND<token_type::Char>, false, static_cast<unsigned char>(value) });
+    }
+
+    void Lexer::EmitId(std::string_view name) {
+        if (!source_.empty()) {
+            EmitSourceText(KIND<token_type::Id>, name);
             return;
         }
-        if (line[i] == '!' && i + 1 < line.size() && line[i + 1] == '=') {
-            lexem_.emplace_back(NotEq());
+        auto [it, inserted] = id_offsets_.emplace(name, static_cast<uint32_t>(arena_.size()));
+        if (inserted) {
+            arena_.append(name);
+        }
+        lexem_.push_back({ KIND<token_type::Id>, false, it->second, static_cast<uint32_t>(name.size()) });
+    }
+
+    //       arena_    offset
+    void Lexer::EmitString(uint32_t offset) {
+        lexem_.push_back({ KIND<token_type::String>, false, offset, static_cast<uint32_t>(arena_.size() - offset) });
+    }
+
+    void Lexer::EmitSourceText(uint8_t kind, std::string_view text) {
+        lexem_.push_back({ kind, true, static_cast<uint32_t>(text.data() - source_.data()),
+            static_cast<uint32_t>(text.size()) });
+    }
+
+    Token Lexer::MakeToken(const CompactToken& token) const {
+        using namespace token_type;
+        switch (token.kind) {
+        case KIND<Number>:
+            return Number{ static_cast<int>(token.payload) };
+        case KIND<Char>:
+            return Char{ static_cast<char>(token.payload) };
+        case KIND<Id>:
+        case KIND<String>: {
+            const std::string_view text = (token.in_source ? source_ : std::string_view(arena_))
+                .substr(token.payload, token.length);
+            if (token.kind == KIND<Id>) {
+                return Id{ std::string(text) };
+            }
+            return String{ std::string(text) };
+        }
+        default:
+            return UNVALUED_TOKENS[token.kind];
+        }
+    }
+
+    void Lexer::ParseOP(std::string_view line, size_t& i) {
+        const uint8_t kind = COMPARISON_KINDS[static_cast<unsigned char>(line[i])];
+        if (kind != NO_KIND && i + 1 < line.size() && line[i + 1] == '=') {
+            lexem_.push_back({ kind });
             ++i;
             return;
         }
-        Char val;
-        val.value = line[i];
-        lexem_.push_back(val);
+        EmitChar(line[i]);
     }
 
-    void Lexer::ParseString(std::string& line, size_t& i, char quote) {
-        using namespace token_type;
+    void Lexer::ParseString(std::string_view line, size_t& i, char quote) {
         ++i;
-        String val;
-        while (line[i] != quote || line[i - 1] == '\\') {
-            if (line[i] == '\\') {
+        const size_t end = scan::SkipStringChars(line, i, quote);
+        if (end == line.size()) {
+            throw LexerError("Unterminated string literal"s, line_);
+        }
+        //   escape-     
+        if (line[end] == quote) {
+            const std::string_view text = line.substr(i, end - i);
+            i = end;
+            if (!source_.empty()) {
+                EmitSourceText(KIND<token_type::String>, text);
+            }
+            else {
+                const auto offset = static_cast<uint32_t>(arena_.size());
+                arena_.append(text);
+                EmitString(offset);
+            }
+            return;
+        }
+
+        const auto offset = static_cast<uint32_t>(arena_.size());
+        while (i == line.size() || line[i] != quote || line[i - 1] == '\\') {
+            if (i == line.size()) {
+                throw LexerError("Unterminated string literal"s, line_);
+            }
+            if (line[i] == '\\' && i + 1 < line.size()) {
                 if (line[i + 1] == 't') {
-                    val.value.push_back('\t');
+                    arena_.push_back('\t');
                     i += 2;
                     continue;
                 }
                 if (line[i + 1] == 'n') {
-                    val.value.push_back('\n');
+                    arena_.push_back('\n');
                     i += 2;
                     continue;
                 }
                 if (line[i + 1] == '\"') {
-                    val.value.push_back('\"');
+                    arena_.push_back('\"');
                     i += 2;
                     continue;;
                 }
                 if (line[i + 1] == quote) {
-                    val.value.push_back(quote);
+                    arena_.push_back(quote);
                     i += 2;
                     continue;
                 }
             }
-            val.value.push_back(line[i]);
+            arena_.push_back(line[i]);
             ++i;
         }
-        lexem_.push_back(val);
+        EmitString(offset);
     }
 
-    void Lexer::ParseKeyword(std::string& line, size_t& i) {
-        using namespace token_type;
-        string s;
-        while (i < line.size() && ((line[i] >= 'A' && line[i] <= 'Z') || (line[i] >= 'a' && line[i] <= 'z')
-            || line[i] == '_' || (line[i] >= '0' && line[i] <= '9'))) {
-            s.push_back(line[i]);
-            ++i;
-        }
+    void Lexer::ParseKeyword(std::string_view line, size_t& i) {
+        const size_t start = i;
+        i = scan::SkipIdChars(line, i);
+        const std::string_view s = line.substr(start, i - start);
         --i;
-        if (s == "class") {
-            lexem_.emplace_back(Class());
+        const Keyword& keyword = KEYWORD_TABLE[KeywordHash(s)];
+        if (keyword.text == s) {
+            lexem_.push_back({ keyword.kind });
             return;
         }
-        if (s == "return") {
-            lexem_.emplace_back(Return());
-            return;
-        }
-        if (s == "if") {
-            lexem_.emplace_back(If());
-            return;
-        }
-        if (s == "else") {
-            lexem_.emplace_back(Else());
-            return;
-        }
-        if (s == "def") {
-            lexem_.emplace_back(Def());
-            return;
-        }
-        if (s == "print") {
-            lexem_.emplace_back(Print());
-            return;
-        }
-        if (s == "and") {
-            lexem_.emplace_back(And());
-            return;
-        }
-        if (s == "or") {
-            lexem_.emplace_back(Or());
-            return;
-        }
-        if (s == "not") {
-            lexem_.emplace_back(Not());
-            return;
-        }
-        if (s == "None") {
-            lexem_.emplace_back(None());
-            return;
+        EmitId(s);
+    }
+
+    Lexer::Lexer(std::istream& input, Mode mode)
+        : input_(&input)
+        , streaming_(mode == Mode::Streaming) {
+        if (streaming_) {
+            ReadTokens();
         }
-        if (s == "True") {
-            lexem_.emplace_back(True());
-            return;
+        else {
+            while (input_) {
+                ReadTokens();
+            }
+            //          
+            id_offsets_ = {};
+            lexem_.shrink_to_fit();
+            arena_.shrink_to_fit();
+            lines_.shrink_to_fit();
         }
-        if (s == "False") {
-            lexem_.emplace_back(False());
-            return;
+        current_ = MakeToken(lexem_[cur_lex_]);
+    }
+
+    Lexer::Lexer(std::shared_ptr<const MappedFile> source)
+        : Lexer(std::move(source), ParallelOptions{ 1 }) {
+    }
+
+    Lexer::Lexer(std::istream& input, const ParallelOptions& options)
+        : input_(nullptr)
+        , streaming_(false) {
+        auto text = std::make_shared<const std::string>(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+        source_ = *text;
+        source_owner_ = std::move(text);
+        ParseSource(options);
+    }
+
+    Lexer::Lexer(std::shared_ptr<const MappedFile> source, const ParallelOptions& options)
+        : input_(nullptr)
+        , streaming_(false) {
+        source_ = source->GetText();
+        source_owner_ = std::move(source);
+        ParseSource(options);
+    }
+
+    Lexer::Lexer(std::string_view source, ChunkTag)
+        : input_(nullptr)
+        , streaming_(false)
+        , source_(source)
+        , mark_indents_(true) {
+    }
+
+    void Lexer::ParseLines(std::string_view text) {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            ++line_;
+            ParseLine(text.substr(pos, end - pos));
+            pos = end + 1;
         }
-        Id id_;
-        id_.value = s;
-        lexem_.push_back(id_);
     }
 
-    Lexer::Lexer(std::istream& in) {
+    void Lexer::ParseSource(const ParallelOptions& options) {
         using namespace token_type;
-        int indent = 0;
-        
-        while (in) {
-            string line;
-            getline(in, line);
-            if (line.size() == 0) {
-                continue;
-            }
-            size_t i = 0;
-            
-            int indent_new = 0;
-            while (i < line.size() && line[i] == ' ') {
-                ++i;
-                ++indent_new;
-            }
-            if (i == line.size() || line[i] == '#') {
-                continue;
-            }
-            indent_new /= 2;
-            while (indent > indent_new) {
-                lexem_.emplace_back(Dedent());
-                --indent;
-            }
-            while (indent < indent_new) {
-                lexem_.emplace_back(Indent());
-                ++indent;
-            }         
+        if (source_.size() > numeric_limits<uint32_t>::max()) {
+            throw LexerError("Source file is too large"s);
+        }
+        const size_t thread_count = options.thread_count != 0
+            ? options.thread_count
+            : std::max<size_t>(thread::hardware_concurrency(), 1);
+        const std::vector<std::string_view> chunks
+            = thread_count > 1 ? SplitLines(source_, options.chunk_size) : std::vector<std::string_view>{};
 
-            for (; i < line.size(); ++i) {
-                if (line[i] == '#') {
-                    break;
-                }
-                if (line[i] == ' ' || line[i] == '\t') {
-                    continue;
-                }
-                if (line[i] >= '0' && line[i] <= '9') {
-                    string s;
-                    while (line[i] >= '0' && line[i] <= '9' && i < line.size()) {
-                        s.push_back(line[i]);
-                        ++i;
+        if (chunks.size() < 2) {
+            ParseLines(source_);
+        }
+        else {
+            std::vector<Lexer> parts;
+            parts.reserve(chunks.size());
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                parts.push_back(Lexer(source_, ChunkTag{}));
+            }
+            std::vector<std::exception_ptr> errors(chunks.size());
+            std::atomic<size_t> next_chunk{ 0 };
+            auto work = [&] {
+                for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+                    try {
+                        parts[i].ParseLines(chunks[i]);
+                    }
+                    catch (...) {
+                        errors[i] = std::current_exception();
                     }
-                    --i;
-                    Number val;
-                    val.value = stoi(s);
-                    lexem_.push_back(val);
-                    continue;
                 }
-                if (line[i] == '.' || line[i] == ',' || line[i] == '(' || line[i] == ')' || line[i] == '+' || line[i] == '-'
-                        || line[i] == '=' || line[i] == '>' || line[i] == '<' || line[i] == '*' || line[i] == '/'
-                        || line[i] == ':' || line[i] == '!') {
+            };
 
-                    ParseOP(line, i);
-                    continue;
+            std::vector<thread> threads;
+            for (size_t i = 1; i < std::min(thread_count, chunks.size()); ++i) {
+                try {
+                    threads.emplace_back(work);
                 }
-
-                if (line[i] == '\'') {    
-                    ParseString(line, i, '\'');
-                    continue;
+                catch (const std::system_error&) {
+                    //    
+                    break;
                 }
-                if (line[i] == '\"') {
-                    ParseString(line, i, '\"');
-                    continue;
+            }
+            work();
+            for (thread& worker : threads) {
+                worker.join();
+            }
+            //          . 
+            //    1,          
+            uint32_t first_line = 0;
+            for (size_t i = 0; i < parts.size(); ++i) {
+                if (errors[i]) {
+                    try {
+                        std::rethrow_exception(errors[i]);
+                    }
+                    catch (const LexerError& e) {
+                        throw LexerError(e.what(), e.GetLine() + first_line);
+                    }
                 }
+                first_line += parts[i].line_;
+            }
 
-                if ((line[i] >= 'A' && line[i] <= 'Z') || (line[i] >= 'a' && line[i] <= 'z') || line[i] == '_') {
-                    ParseKeyword(line, i);
-                    continue;
+            size_t token_count = 0;
+            size_t arena_size = 0;
+            size_t line_count = 0;
+            for (const Lexer& part : parts) {
+                token_count += part.lexem_.size();
+                arena_size += part.arena_.size();
+                line_count += part.lines_.size();
+            }
+            lexem_.reserve(token_count);
+            arena_.reserve(arena_size);
+            lines_.reserve(line_count);
+            for (Lexer& part : parts) {
+                const auto arena_offset = static_cast<uint32_t>(arena_.size());
+                arena_ += part.arena_;
+                //       INDENT_MARK
+                auto part_line = part.lines_.begin();
+                for (CompactToken token : part.lexem_) {
+                    if (token.kind == INDENT_MARK) {
+                        lines_.push_back({ static_cast<uint32_t>(lexem_.size()), line_ + (part_line++)->line });
+                        EmitIndents(static_cast<int>(token.payload));
+                        continue;
+                    }
+                    if (!token.in_source && (token.kind == KIND<Id> || token.kind == KIND<String>)) {
+                        token.payload += arena_offset;
+                    }
+                    lexem_.push_back(token);
                 }
+                line_ += part.line_;
+                part.lexem_ = {};
+                part.arena_ = {};
+                part.lines_ = {};
+            }
+        }
+        EmitEof();
+        lexem_.shrink_to_fit();
+        arena_.shrink_to_fit();
+        current_ = MakeToken(lexem_[cur_lex_]);
+    }
 
-                Char val1;
-                val1.value = line[i];
-                lexem_.push_back(val1);
+    void Lexer::ReadTokens() {
+        string line;
+        while (getline(*input_, line)) {
+            ++line_;
+            if (ParseLine(line)) {
+                return;
             }
-            lexem_.emplace_back(Newline());
         }
-        while (indent > 0) {
-            lexem_.emplace_back(Dedent());
-            --indent;
+        EmitEof();
+        input_ = nullptr;
+    }
+
+    void Lexer::EmitIndents(int indent_new) {
+        using namespace token_type;
+        while (indent_ > indent_new) {
+            Emit<Dedent>();
+            --indent_;
+        }
+        while (indent_ < indent_new) {
+            Emit<Indent>();
+            ++indent_;
         }
-        lexem_.emplace_back(Eof());
     }
 
-    const Token& Lexer::CurrentToken() const {
-        // .   
-        if (cur_lex_ + 1 >= lexem_.size()) {
-            return lexem_.back();
-            //throw std::logic_error("Not implemented"s);
+    void Lexer::EmitEof() {
+        using namespace token_type;
+        while (indent_ > 0) {
+            Emit<Dedent>();
+            --indent_;
         }
-        return lexem_[cur_lex_];
+        Emit<Eof>();
+    }
+
+    bool Lexer::ParseLine(std::string_view line) {
+        using namespace token_type;
+        size_t i = scan::SkipSpaces(line, 0);
+        if (i == line.size() || line[i] == '#') {
+            return false;
+        }
+        const int indent_new = static_cast<int>(i / 2);
+        lines_.push_back({ static_cast<uint32_t>(lexem_.size()), line_ });
+        if (mark_indents_) {
+            lexem_.push_back({ INDENT_MARK, false, static_cast<uint32_t>(indent_new) });
+        }
+        else {
+            EmitIndents(indent_new);
+        }
+
+        for (; i < line.size(); ++i) {
+            const CharClass char_class = GetCharClass(line[i]);
+            if (char_class == CharClass::Comment) {
+                break;
+            }
+            switch (char_class) {
+            case CharClass::Blank:
+                i = scan::SkipBlanks(line, i) - 1;
+                break;
+            case CharClass::Digit: {
+                const size_t start = i;
+                i = scan::SkipDigits(line, i);
+                int value = 0;
+                if (from_chars(line.data() + start, line.data() + i, value).ec != errc{}) {
+                    throw LexerError("Number is out of range: "s + std::string(line.substr(start, i - start)), line_);
+                }
+                --i;
+                EmitNumber(value);
+                break;
+            }
+            case CharClass::Operator:
+                ParseOP(line, i);
+                break;
+            case CharClass::Quote:
+                ParseString(line, i, line[i]);
+                break;
+            case CharClass::Letter:
+                ParseKeyword(line, i);
+                break;
+            default:
+                EmitChar(line[i]);
+            }
+        }
+        Emit<Newline>();
+        return true;
+    }
+
+    const Token& Lexer::CurrentToken() const {
+        return current_;
     }
 
     Token Lexer::NextToken() {
         if (cur_lex_ + 1 >= lexem_.size()) {
-            return lexem_.back();
-            //throw std::logic_error("Not implemented"s);
+            if (!streaming_ || !input_) {
+                return current_;
+            }
+            //    ,     current_,  
+            //     
+            lexem_.clear();
+            arena_.clear();
+            id_offsets_.clear();
+            //        
+            lines_ = { { 0, lines_.back().line } };
+            cur_lex_ = 0;
+            ReadTokens();
+            current_ = MakeToken(lexem_[cur_lex_]);
+            return current_;
         }
         ++cur_lex_;
-        return lexem_[cur_lex_];
+        current_ = MakeToken(lexem_[cur_lex_]);
+        return current_;
+    }
+
+    size_t Lexer::GetPosition() const {
+        if (streaming_) {
+            throw logic_error("Streaming lexer doesn't keep token positions"s);
+        }
+        return cur_lex_;
+    }
+
+    void Lexer::SetPosition(size_t position) {
+        if (streaming_) {
+            throw logic_error("Streaming lexer doesn't keep token positions"s);
+        }
+        if (position >= lexem_.size()) {
+            throw out_of_range("Token position is out of range"s);
+        }
+        cur_lex_ = position;
+        current_ = MakeToken(lexem_[cur_lex_]);
+    }
+
+    size_t Lexer::GetLine() const {
+        //  ,      
+        const auto it = upper_bound(lines_.begin(), lines_.end(), cur_lex_,
+            [](size_t token, const LineStart& line) {
+                return token < line.token;
+            });
+        return it == lines_.begin() ? 0 : prev(it)->line;
     }
 
 }  // namespace parse
@@ -1,16 +1,22 @@
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 //#include <iostream>
 
 namespace parse {
 
+    class MappedFile;
+
     namespace token_type {
         struct Number {  //  
             int value;   // 
@@ -48,6 +54,8 @@ namespace parse {
         struct None {};         //  None
         struct True {};         //  True
         struct False {};        //  False
+        struct Spawn {};        //  spawn
+        struct Yield {};        //  yield
     }  // namespace token_type
 
     using TokenBase
@@ -56,7 +64,8 @@ namespace parse {
         token_type::Def, token_type::Newline, token_type::Print, token_type::Indent,
         token_type::Dedent, token_type::And, token_type::Or, token_type::Not,
         token_type::Eq, token_type::NotEq, token_type::LessOrEq, token_type::GreaterOrEq,
-        token_type::None, token_type::True, token_type::False, token_type::Eof>;
+        token_type::None, token_type::True, token_type::False, token_type::Spawn, token_type::Yield,
+        token_type::Eof>;
 
     struct Token : TokenBase {
         using TokenBase::TokenBase;
@@ -85,11 +94,53 @@ namespace parse {
     class LexerError : public std::runtime_error {
     public:
         using std::runtime_error::runtime_error;
+
+        //    line  ,    1
+        LexerError(const std::string& message, size_t line)
+            : std::runtime_error(message)
+            , line_(line) {
+        }
+
+        //    , 0 -   
+        [[nodiscard]] size_t GetLine() const {
+            return line_;
+        }
+
+    private:
+        size_t line_ = 0;
     };
 
     class Lexer {
     public:
-        explicit Lexer(std::istream& input);
+        enum class Mode {
+            //       
+            Eager,
+            //        NextToken.    
+            //    ,       
+            Streaming,
+        };
+
+        explicit Lexer(std::istream& input, Mode mode = Mode::Eager);
+
+        //   ,   ,    . 
+        //      escape-  
+        //  ,      
+        explicit Lexer(std::shared_ptr<const MappedFile> source);
+
+        //         
+        struct ParallelOptions {
+            //  , 0 -    
+            size_t thread_count = 0;
+            //      .     
+            size_t chunk_size = 1 << 20;
+        };
+
+        //           ,  
+        //    ,  Indent  Dedent   .
+        //         .
+        //  input  
+        Lexer(std::istream& input, const ParallelOptions& options);
+        Lexer(std::shared_ptr<const MappedFile> source, const ParallelOptions& options);
 
         //       token_type::Eof,    
         [[nodiscard]] const Token& CurrentToken() const;
@@ -97,13 +148,23 @@ namespace parse {
         //   ,  token_type::Eof,    
         Token NextToken();
 
+        //     . SetPosition     ,
+        //         .   Streaming
+        //    ,     std::logic_error
+        [[nodiscard]] size_t GetPosition() const;
+        void SetPosition(size_t position);
+
+        //    ,     .  
+        //  1, Eof     ,       0
+        [[nodiscard]] size_t GetLine() const;
+
         //      T,     .
         //       LexerError
         template <typename T>
         const T& Expect() const {
             using namespace std::literals;
-            if (lexem_[cur_lex_].Is<T>()) {
-                return lexem_[cur_lex_].As<T>();
+            if (CurrentToken().Is<T>()) {
+                return CurrentToken().As<T>();
             }
             else {
                 throw LexerError("Not implemented"s);
@@ -154,13 +215,77 @@ namespace parse {
             }
         }
 
-        void ParseOP(std::string& line, size_t& i);
-        void ParseString(std::string& line, size_t& i, char quote);
-        void ParseKeyword(std::string& line, size_t& i);
+        void ParseOP(std::string_view line, size_t& i);
+        void ParseString(std::string_view line, size_t& i, char quote);
+        void ParseKeyword(std::string_view line, size_t& i);
 
     private:
-        std::vector<Token> lexem_;
+        struct ChunkTag {};
+
+        //    source.  Indent  Dedent    
+        Lexer(std::string_view source, ChunkTag);
+
+        //   .       
+        // TokenBase.  Number  Char  payload  ,  Id  String - 
+        //    source_,  in_source,   arena_,   length -  
+        struct CompactToken {
+            uint8_t kind;
+            bool in_source = false;
+            uint32_t payload = 0;
+            uint32_t length = 0;
+        };
+
+        //      .   ,
+        //  ,  Eof   input_
+        void ReadTokens();
+        //   .  false,       
+        bool ParseLine(std::string_view line);
+        //   text,  source_
+        void ParseLines(std::string_view text);
+        //  source_     ,    Eof
+        void ParseSource(const ParallelOptions& options);
+        //  Indent  Dedent,     indent_new
+        void EmitIndents(int indent_new);
+        //      Eof
+        void EmitEof();
+
+        template <typename T>
+        void Emit();
+        void EmitNumber(int value);
+        void EmitChar(char value);
+        void EmitId(std::string_view name);
+        void EmitString(uint32_t offset);
+        //    kind,   -  source_
+        void EmitSourceText(uint8_t kind, std::string_view text);
+
+        [[nodiscard]] Token MakeToken(const CompactToken& token) const;
+
+        //           lexem_
+        struct LineStart {
+            uint32_t token;
+            uint32_t line;
+        };
+
+        std::vector<CompactToken> lexem_;
+        //     ,  .
+        //      
+        std::string arena_;
+        std::unordered_map<std::string, uint32_t> id_offsets_;
+        std::vector<LineStart> lines_;
+        //    ,     
+        uint32_t line_ = 0;
         size_t cur_lex_ = 0;
+        std::istream* input_;
+        bool streaming_;
+        int indent_ = 0;
+        //  ,       ,   :
+        //     
+        std::shared_ptr<const void> source_owner_;
+        std::string_view source_;
+        //        Indent  Dedent
+        bool mark_indents_ = false;
+        //     ,    CurrentToken()  Expect()
+        Token current_;
     };
 
 }  // namespace parse
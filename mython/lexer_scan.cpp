@@ -0,0 +1,261 @@
+#include "lexer_scan.h"
+
+#include <atomic>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define MYTHON_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace parse::scan {
+
+    namespace {
+        //  .    operator()      
+        //     (   -  0xFF)
+        struct Spaces {
+            bool operator()(char c) const {
+                return c == ' ';
+            }
+#ifdef MYTHON_SCAN_X86
+            __m128i operator()(__m128i v) const {
+                return _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+            }
+
+            __attribute__((target("avx2"))) __m256i operator()(__m256i v) const {
+                return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+            }
+#endif
+        };
+
+        struct Blanks {
+            bool operator()(char c) const {
+                return c == ' ' || c == '\t';
+            }
+#ifdef MYTHON_SCAN_X86
+            __m128i operator()(__m128i v) const {
+                return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+            }
+
+            __attribute__((target("avx2"))) __m256i operator()(__m256i v) const {
+                return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+            }
+#endif
+        };
+
+        //   0x7F         
+        struct Digits {
+            bool operator()(char c) const {
+                return c >= '0' && c <= '9';
+            }
+#ifdef MYTHON_SCAN_X86
+            __m128i operator()(__m128i v) const {
+                return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+            }
+
+            __attribute__((target("avx2"))) __m256i operator()(__m256i v) const {
+                return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                    _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+            }
+#endif
+        };
+
+        //     0x20    'a'..'z',   - 
+        struct IdChars {
+            bool operator()(char c) const {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            }
+#ifdef MYTHON_SCAN_X86
+            __m128i operator()(__m128i v) const {
+                const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+                const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+                return _mm_or_si128(_mm_or_si128(letter, Digits{}(v)), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+            }
+
+            __attribute__((target("avx2"))) __m256i operator()(__m256i v) const {
+                const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+                const __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                    _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+                return _mm256_or_si256(_mm256_or_si256(letter, Digits{}(v)),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+            }
+#endif
+        };
+
+        struct StringChars {
+            char quote;
+
+            bool operator()(char c) const {
+                return c != quote && c != '\\';
+            }
+#ifdef MYTHON_SCAN_X86
+            __m128i operator()(__m128i v) const {
+                const __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(quote)),
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+                return _mm_cmpeq_epi8(stop, _mm_setzero_si128());
+            }
+
+            __attribute__((target("avx2"))) __m256i operator()(__m256i v) const {
+                const __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(quote)),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')));
+                return _mm256_cmpeq_epi8(stop, _mm256_setzero_si256());
+            }
+#endif
+        };
+
+        //     StringChars,     
+        template <typename Class>
+        Class MakeClass(char quote) {
+            if constexpr (std::is_same_v<Class, StringChars>) {
+                return Class{ quote };
+            }
+            else {
+                return Class{};
+            }
+        }
+
+        template <typename Class>
+        size_t ScanScalar(std::string_view text, size_t pos, char quote) {
+            const Class cls = MakeClass<Class>(quote);
+            while (pos < text.size() && cls(text[pos])) {
+                ++pos;
+            }
+            return pos;
+        }
+
+#ifdef MYTHON_SCAN_X86
+        //        text,  - 
+        template <typename Class>
+        size_t ScanSse2(std::string_view text, size_t pos, char quote) {
+            const Class cls = MakeClass<Class>(quote);
+            while (pos + sizeof(__m128i) <= text.size()) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+                const unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(cls(chunk))) & 0xFFFFu;
+                if (stop != 0) {
+                    return pos + __builtin_ctz(stop);
+                }
+                pos += sizeof(__m128i);
+            }
+            return ScanScalar<Class>(text, pos, quote);
+        }
+
+        template <typename Class>
+        __attribute__((target("avx2"))) size_t ScanAvx2(std::string_view text, size_t pos, char quote) {
+            const Class cls = MakeClass<Class>(quote);
+            while (pos + sizeof(__m256i) <= text.size()) {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + pos));
+                const unsigned stop = ~static_cast<unsigned>(_mm256_movemask_epi8(cls(chunk)));
+                if (stop != 0) {
+                    return pos + __builtin_ctz(stop);
+                }
+                pos += sizeof(__m256i);
+            }
+            //        ymm   ,
+            //   SSE  VEX-     
+            _mm256_zeroupper();
+            return ScanSse2<Class>(text, pos, quote);
+        }
+#endif
+
+        using ScanFunction = size_t (*)(std::string_view text, size_t pos, char quote);
+
+        struct Scanners {
+            Isa isa;
+            ScanFunction spaces;
+            ScanFunction blanks;
+            ScanFunction digits;
+            ScanFunction id_chars;
+            ScanFunction string_chars;
+        };
+
+        const Scanners SCALAR = { Isa::Scalar, ScanScalar<Spaces>, ScanScalar<Blanks>, ScanScalar<Digits>,
+            ScanScalar<IdChars>, ScanScalar<StringChars> };
+#ifdef MYTHON_SCAN_X86
+        const Scanners SSE2 = { Isa::Sse2, ScanSse2<Spaces>, ScanSse2<Blanks>, ScanSse2<Digits>,
+            ScanSse2<IdChars>, ScanSse2<StringChars> };
+        const Scanners AVX2 = { Isa::Avx2, ScanAvx2<Spaces>, ScanAvx2<Blanks>, ScanAvx2<Digits>,
+            ScanAvx2<IdChars>, ScanAvx2<StringChars> };
+#endif
+
+        const Scanners* FindScanners(Isa isa) {
+            switch (isa) {
+            case Isa::Scalar:
+                return &SCALAR;
+#ifdef MYTHON_SCAN_X86
+            case Isa::Sse2:
+                return &SSE2;
+            case Isa::Avx2:
+                return __builtin_cpu_supports("avx2") ? &AVX2 : nullptr;
+#endif
+            default:
+                return nullptr;
+            }
+        }
+
+        //     ,      ,
+        //       
+        atomic<const Scanners*>& CurrentScanners() {
+            static atomic<const Scanners*> current{ FindScanners(DetectIsa()) };
+            return current;
+        }
+    }  // namespace
+
+    Isa DetectIsa() {
+#ifdef MYTHON_SCAN_X86
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? Isa::Avx2 : Isa::Sse2;
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    Isa GetIsa() {
+        return CurrentScanners().load(memory_order_relaxed)->isa;
+    }
+
+    bool SetIsa(Isa isa) {
+        const Scanners* scanners = FindScanners(isa);
+        if (!scanners) {
+            return false;
+        }
+        CurrentScanners().store(scanners, memory_order_relaxed);
+        return true;
+    }
+
+    std::string_view GetIsaName(Isa isa) {
+        switch (isa) {
+        case Isa::Sse2:
+            return "SSE2"sv;
+        case Isa::Avx2:
+            return "AVX2"sv;
+        default:
+            return "scalar"sv;
+        }
+    }
+
+    size_t SkipSpaces(std::string_view text, size_t pos) {
+        return CurrentScanners().load(memory_order_relaxed)->spaces(text, pos, 0);
+    }
+
+    size_t SkipBlanks(std::string_view text, size_t pos) {
+        return CurrentScanners().load(memory_order_relaxed)->blanks(text, pos, 0);
+    }
+
+    size_t SkipDigits(std::string_view text, size_t pos) {
+        return CurrentScanners().load(memory_order_relaxed)->digits(text, pos, 0);
+    }
+
+    size_t SkipIdChars(std::string_view text, size_t pos) {
+        return CurrentScanners().load(memory_order_relaxed)->id_chars(text, pos, 0);
+    }
+
+    size_t SkipStringChars(std::string_view text, size_t pos, char quote) {
+        return CurrentScanners().load(memory_order_relaxed)->string_chars(text, pos, quote);
+    }
+
+}  // namespace parse::scan
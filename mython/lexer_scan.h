@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+//      : , ,  
+//  .  x86    16 (SSE2)  32 (AVX2)   ,
+//         .
+//      ,   pos,   ,
+//  text.size()
+namespace parse::scan {
+
+    enum class Isa {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    //   ,  
+    [[nodiscard]] Isa DetectIsa();
+
+    //  ,   
+    [[nodiscard]] Isa GetIsa();
+
+    //       isa.  false    ,
+    //     
+    bool SetIsa(Isa isa);
+
+    [[nodiscard]] std::string_view GetIsaName(Isa isa);
+
+    // 
+    [[nodiscard]] size_t SkipSpaces(std::string_view text, size_t pos);
+    //   
+    [[nodiscard]] size_t SkipBlanks(std::string_view text, size_t pos);
+    //  
+    [[nodiscard]] size_t SkipDigits(std::string_view text, size_t pos);
+    //  ,   
+    [[nodiscard]] size_t SkipIdChars(std::string_view text, size_t pos);
+    //       quote    
+    [[nodiscard]] size_t SkipStringChars(std::string_view text, size_t pos, char quote);
+
+}  // namespace parse::scan
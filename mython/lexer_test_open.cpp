@@ -1,18 +1,37 @@
 #include "lexer.h"
+#include "lexer_scan.h"
+#include "mapped_file.h"
 #include "test_runner_p.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace std;
 
 namespace parse {
 
     namespace {
+        //   ,    ,   
+        optional<Lexer::ParallelOptions> parallel_options;
+
+        Lexer MakeLexer(istream& input) {
+            if (parallel_options) {
+                return Lexer(input, *parallel_options);
+            }
+            return Lexer(input);
+        }
+
         void TestSimpleAssignment() {
             istringstream input("x = 42\n"s);
 
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
@@ -25,7 +44,7 @@ namespace parse {
 
         void TestKeywords() {
             istringstream input("class return if else def print or None and not True False"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Class{}));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Return{}));
@@ -43,7 +62,7 @@ namespace parse {
 
         void TestNumbers() {
             istringstream input("42 15 -53"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Number{ 42 }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{ 15 }));
@@ -54,7 +73,7 @@ namespace parse {
 
         void TestIds() {
             istringstream input("x    _42 big_number   Return Class  dEf"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "_42"s }));
@@ -65,10 +84,29 @@ namespace parse {
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "dEf"s }));
         }
 
+        void TestRepeatedIds() {
+            istringstream input("x = y\nx = 'x'\ny = x\n"s);
+            Lexer lexer = MakeLexer(input);
+
+            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "y"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "x"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "y"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+        }
+
         void TestStrings() {
             istringstream input(
                 R"('word' "two words" 'long string with a double quote " inside' "another long string with single quote ' inside")"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::String{ "word"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::String{ "two words"s }));
@@ -80,7 +118,7 @@ namespace parse {
 
         void TestOperations() {
             istringstream input("+-*/= > < != == <> <= >="s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Char{ '+' }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '-' }));
@@ -111,7 +149,7 @@ no_indent
 no_indent
 )"s);
 
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "no_indent"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
@@ -153,7 +191,7 @@ x = 1
 
 
 )"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
@@ -190,7 +228,7 @@ class Point:
 p = Point(1, 2)
 print str(p)
 )"s);
-            Lexer lexer(input);
+            Lexer lexer = MakeLexer(input);
 
             ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
             ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
@@ -276,7 +314,7 @@ print str(p)
 
         void TestExpect() {
             istringstream is("bugaga"s);
-            Lexer lex(is);
+            Lexer lex = MakeLexer(is);
 
             ASSERT_DOESNT_THROW(lex.Expect<token_type::Id>());
             ASSERT_EQUAL(lex.Expect<token_type::Id>().value, "bugaga"s);
@@ -287,7 +325,7 @@ print str(p)
 
         void TestExpectNext() {
             istringstream is("+ bugaga + def 52"s);
-            Lexer lex(is);
+            Lexer lex = MakeLexer(is);
 
             ASSERT_EQUAL(lex.CurrentToken(), Token(token_type::Char{ '+' }));
             ASSERT_DOESNT_THROW(lex.ExpectNext<token_type::Id>());
@@ -299,7 +337,7 @@ print str(p)
         void TestAlwaysEmitsNewlineAtTheEndOfNonemptyLine() {
             {
                 istringstream is("a b"s);
-                Lexer lexer(is);
+                Lexer lexer = MakeLexer(is);
 
                 ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "a"s }));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "b"s }));
@@ -310,7 +348,7 @@ print str(p)
             }
             {
                 istringstream is("+"s);
-                Lexer lexer(is);
+                Lexer lexer = MakeLexer(is);
 
                 ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Char{ '+' }));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
@@ -321,7 +359,7 @@ print str(p)
             {
                 istringstream is(R"(# comment
 )"s);
-                Lexer lexer(is);
+                Lexer lexer = MakeLexer(is);
 
                 ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Eof{}));
             }
@@ -329,7 +367,7 @@ print str(p)
                 istringstream is(R"(# comment
 
 )"s);
-                Lexer lexer(is);
+                Lexer lexer = MakeLexer(is);
                 ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Eof{}));
             }
             {
@@ -340,7 +378,7 @@ abc#
 "#123"
 #)"s);
 
-                Lexer lexer(is);
+                Lexer lexer = MakeLexer(is);
                 ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "abc"s }));
@@ -352,22 +390,243 @@ abc#
                 ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
             }
         }
+
+        void TestStreamingMatchesEager() {
+            const string program = R"(x = 4 # comment
+class Point:
+  def __init__(x, y):
+
+    self.x = x
+    # comment
+    self.y = 'x' + "y\n"
+print Point(1, 2).x, x, x
+    )"s;
+            istringstream eager_input(program);
+            istringstream streaming_input(program);
+            Lexer eager(eager_input);
+            Lexer streaming(streaming_input, Lexer::Mode::Streaming);
+
+            ASSERT_EQUAL(streaming.CurrentToken(), eager.CurrentToken());
+            while (!eager.CurrentToken().Is<token_type::Eof>()) {
+                ASSERT_EQUAL(streaming.NextToken(), eager.NextToken());
+                ASSERT_EQUAL(streaming.GetLine(), eager.GetLine());
+            }
+            ASSERT_EQUAL(streaming.NextToken(), Token(token_type::Eof{}));
+            ASSERT_EQUAL(streaming.NextToken(), Token(token_type::Eof{}));
+        }
+
+        void TestStreamingReadsOnDemand() {
+            istringstream is("\n# comment\nx = 1\ny = 2\nz = 3\n"s);
+            Lexer lexer(is, Lexer::Mode::Streaming);
+
+            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(static_cast<int>(is.tellg()), 17);
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Number{ 1 }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+            ASSERT_EQUAL(static_cast<int>(is.tellg()), 17);
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Id{ "y"s }));
+            ASSERT_EQUAL(static_cast<int>(is.tellg()), 23);
+            ASSERT_EQUAL(lexer.Expect<token_type::Id>().value, "y"s);
+            ASSERT_DOESNT_THROW(lexer.ExpectNext<token_type::Char>('='));
+        }
+
+        void TestMappedFile() {
+            const string program = R"(x = 'it\'s' + "plain"
+class Point:
+  def __init__(x):
+    # comment
+
+    self.x = x
+print Point(1).x, "tab\tbed", x
+)"s;
+            const string path = (filesystem::temp_directory_path() / "mython_lexer_test.my"s).string();
+            ofstream(path, ios::binary) << program;
+
+            Lexer mapped(make_shared<const MappedFile>(path));
+            remove(path.c_str());
+            istringstream input(program);
+            Lexer eager(input);
+
+            ASSERT_EQUAL(mapped.CurrentToken(), eager.CurrentToken());
+            while (!eager.CurrentToken().Is<token_type::Eof>()) {
+                ASSERT_EQUAL(mapped.NextToken(), eager.NextToken());
+            }
+            ASSERT_EQUAL(mapped.NextToken(), Token(token_type::Eof{}));
+
+            ASSERT_THROWS(MappedFile("no_such_mython_file.my"s), runtime_error);
+        }
+
+        void TestUnterminatedString() {
+            istringstream plain("x = 'abc\n"s);
+            ASSERT_THROWS(MakeLexer(plain), LexerError);
+            istringstream escaped("x = 'ab\\tc\n"s);
+            ASSERT_THROWS(MakeLexer(escaped), LexerError);
+        }
+
+        void TestLineNumbers() {
+            istringstream input("\nx = 1\n# comment\nif x:\n\n  y = 'a'\nz = 2\n\n"s);
+            Lexer lexer = MakeLexer(input);
+
+            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ "x"s }));
+            ASSERT_EQUAL(lexer.GetLine(), 2u);
+            while (!lexer.CurrentToken().Is<token_type::If>()) {
+                lexer.NextToken();
+            }
+            ASSERT_EQUAL(lexer.GetLine(), 4u);
+            while (!lexer.CurrentToken().Is<token_type::Indent>()) {
+                lexer.NextToken();
+            }
+            ASSERT_EQUAL(lexer.GetLine(), 6u);
+            // Dedent   ,    
+            while (!lexer.CurrentToken().Is<token_type::Dedent>()) {
+                lexer.NextToken();
+            }
+            ASSERT_EQUAL(lexer.GetLine(), 7u);
+            while (!lexer.CurrentToken().Is<token_type::Eof>()) {
+                lexer.NextToken();
+            }
+            ASSERT_EQUAL(lexer.GetLine(), 7u);
+
+            istringstream empty("\n# comment\n"s);
+            ASSERT_EQUAL(MakeLexer(empty).GetLine(), 0u);
+
+            istringstream error("x = 1\n\ny = 'abc\n"s);
+            try {
+                MakeLexer(error);
+                ASSERT(false);
+            }
+            catch (const LexerError& e) {
+                ASSERT_EQUAL(e.GetLine(), 3u);
+            }
+        }
+
+        void TestScanIsas() {
+            //   ,      ,    
+            string text;
+            for (int length = 0; length < 70; ++length) {
+                text += string(length, ' ') + "\t"s + string(length, '7') + "x"s + string(length, 'a') + "_Z9"s
+                    + string(length, 'q') + "\\"s + string(length, '\xC0') + "'\"\x80"s;
+            }
+            const auto scanners = { scan::SkipSpaces, scan::SkipBlanks, scan::SkipDigits, scan::SkipIdChars };
+
+            const scan::Isa detected = scan::GetIsa();
+            vector<size_t> expected;
+            ASSERT(scan::SetIsa(scan::Isa::Scalar));
+            for (size_t pos = 0; pos <= text.size(); ++pos) {
+                for (const auto skip : scanners) {
+                    expected.push_back(skip(text, pos));
+                }
+                expected.push_back(scan::SkipStringChars(text, pos, '\''));
+                expected.push_back(scan::SkipStringChars(text, pos, '"'));
+            }
+
+            for (const scan::Isa isa : { scan::Isa::Sse2, scan::Isa::Avx2 }) {
+                if (!scan::SetIsa(isa)) {
+                    continue;
+                }
+                vector<size_t> found;
+                for (size_t pos = 0; pos <= text.size(); ++pos) {
+                    for (const auto skip : scanners) {
+                        found.push_back(skip(text, pos));
+                    }
+                    found.push_back(scan::SkipStringChars(text, pos, '\''));
+                    found.push_back(scan::SkipStringChars(text, pos, '"'));
+                }
+                ASSERT_EQUAL(found, expected);
+            }
+            ASSERT(scan::SetIsa(detected));
+            ASSERT(scan::SetIsa(scan::DetectIsa()));
+        }
+
+        void TestKeywordLookalikes() {
+            // cxxxs, rn_urn, none  Fe_se      ,    
+            istringstream input("cxxxs rn_urn none Fe_se Class iff print_ _if ! = !== <<= >"s);
+            Lexer lexer = MakeLexer(input);
+
+            for (const string& id : { "cxxxs"s, "rn_urn"s, "none"s, "Fe_se"s, "Class"s, "iff"s, "print_"s, "_if"s }) {
+                ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Id{ id }));
+                lexer.NextToken();
+            }
+            ASSERT_EQUAL(lexer.CurrentToken(), Token(token_type::Char{ '!' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::NotEq{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '=' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '<' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::LessOrEq{}));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Char{ '>' }));
+            ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Newline{}));
+        }
+
+        void TestParallelLexing() {
+            string program;
+            for (int i = 0; i < 300; ++i) {
+                program += "class C"s + to_string(i) + ":\n  def m(x):\n    if x:\n      # comment\n\n"s
+                    + "      return 'a\\tb' + \"c\"\n    else:\n      x = x + "s + to_string(i) + "\n"s
+                    + (i % 7 == 0 ? "  y = None\n"s : ""s) + "x = C"s + to_string(i) + "()\n"s;
+            }
+            for (const Lexer::ParallelOptions& options : { Lexer::ParallelOptions{ 4, 1 },
+                     Lexer::ParallelOptions{ 3, 100 }, Lexer::ParallelOptions{ 0, 4096 }, Lexer::ParallelOptions{} }) {
+                istringstream eager_input(program);
+                Lexer eager(eager_input);
+                istringstream input(program);
+                Lexer lexer(input, options);
+
+                ASSERT_EQUAL(lexer.CurrentToken(), eager.CurrentToken());
+                while (!eager.CurrentToken().Is<token_type::Eof>()) {
+                    ASSERT_EQUAL(lexer.NextToken(), eager.NextToken());
+                }
+                ASSERT_EQUAL(lexer.NextToken(), Token(token_type::Eof{}));
+            }
+
+            //      ,    
+            istringstream input(program + "x = 9999999999\n"s + program + "x = 'unterminated\n"s);
+            try {
+                Lexer lexer(input, Lexer::ParallelOptions{ 4, 64 });
+                ASSERT(false);
+            }
+            catch (const LexerError& e) {
+                ASSERT_EQUAL(string(e.what()), "Number is out of range: 9999999999"s);
+                ASSERT_EQUAL(e.GetLine(), static_cast<size_t>(count(program.begin(), program.end(), '\n') + 1));
+            }
+        }
+
+        void RunLexerTests(TestRunner& tr) {
+            RUN_TEST(tr, parse::TestSimpleAssignment);
+            RUN_TEST(tr, parse::TestKeywords);
+            RUN_TEST(tr, parse::TestNumbers);
+            RUN_TEST(tr, parse::TestIds);
+            RUN_TEST(tr, parse::TestRepeatedIds);
+            RUN_TEST(tr, parse::TestStrings);
+            RUN_TEST(tr, parse::TestOperations);
+            RUN_TEST(tr, parse::TestIndentsAndNewlines);
+            RUN_TEST(tr, parse::TestEmptyLinesAreIgnored);
+            RUN_TEST(tr, parse::TestExpect);
+            RUN_TEST(tr, parse::TestExpectNext);
+            RUN_TEST(tr, parse::TestMythonProgram);
+            RUN_TEST(tr, parse::TestAlwaysEmitsNewlineAtTheEndOfNonemptyLine);
+            RUN_TEST(tr, parse::TestCommentsAreIgnored);
+            RUN_TEST(tr, parse::TestUnterminatedString);
+            RUN_TEST(tr, parse::TestKeywordLookalikes);
+            RUN_TEST(tr, parse::TestLineNumbers);
+        }
     }  // namespace
 
     void RunOpenLexerTests(TestRunner& tr) {
-        RUN_TEST(tr, parse::TestSimpleAssignment);
-        RUN_TEST(tr, parse::TestKeywords);
-        RUN_TEST(tr, parse::TestNumbers);
-        RUN_TEST(tr, parse::TestIds);
-        RUN_TEST(tr, parse::TestStrings);
-        RUN_TEST(tr, parse::TestOperations);
-        RUN_TEST(tr, parse::TestIndentsAndNewlines);
-        RUN_TEST(tr, parse::TestEmptyLinesAreIgnored);
-        RUN_TEST(tr, parse::TestExpect);
-        RUN_TEST(tr, parse::TestExpectNext);
-        RUN_TEST(tr, parse::TestMythonProgram);
-        RUN_TEST(tr, parse::TestAlwaysEmitsNewlineAtTheEndOfNonemptyLine);
-        RUN_TEST(tr, parse::TestCommentsAreIgnored);
+        RunLexerTests(tr);
+
+        //   -  ,     
+        parallel_options = Lexer::ParallelOptions{ 4, 1 };
+        RunLexerTests(tr);
+        parallel_options = Lexer::ParallelOptions{ 3, 10 };
+        RunLexerTests(tr);
+        parallel_options.reset();
+
+        RUN_TEST(tr, parse::TestStreamingMatchesEager);
+        RUN_TEST(tr, parse::TestStreamingReadsOnDemand);
+        RUN_TEST(tr, parse::TestMappedFile);
+        RUN_TEST(tr, parse::TestScanIsas);
+        RUN_TEST(tr, parse::TestParallelLexing);
     }
 
-}  // namespace parse
\ No newline at end of file
+}  // namespace parse
@@ -1,10 +1,24 @@
-﻿#include "lexer.h"
+﻿#include "async_output.h"
+#include "heap_profiler.h"
+#include "lexer.h"
+#include "mapped_file.h"
+#include "mython.h"
 #include "parse.h"
+#include "parse_check.h"
+#include "program_cache.h"
 #include "runtime.h"
+#include "server.h"
+#include "snapshot.h"
 #include "statement.h"
+#include "tasks.h"
 #include "test_runner_p.h"
 
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
 
@@ -18,19 +32,167 @@ namespace ast {
 namespace runtime {
     void RunObjectHolderTests(TestRunner& tr);
     void RunObjectsTests(TestRunner& tr);
+    void RunTasksTests(TestRunner& tr);
+    void RunGeneratorTests(TestRunner& tr);
+    void RunAsyncOutputTests(TestRunner& tr);
+    void RunExecutionBudgetTests(TestRunner& tr);
 }  // namespace runtime
 
 void TestParseProgram(TestRunner& tr);
 
+namespace flat_ast {
+    void RunProgramCacheTests(TestRunner& tr);
+    void RunSnapshotTests(TestRunner& tr);
+    void RunLaneEvaluatorTests(TestRunner& tr);
+}  // namespace flat_ast
+
+namespace mython {
+    void RunMythonTests(TestRunner& tr);
+    void RunBatchTests(TestRunner& tr);
+    void RunServerTests(TestRunner& tr);
+}  // namespace mython
+
 namespace {
 
-    void RunMythonProgram(istream& input, ostream& output) {
-        parse::Lexer lexer(input);
-        auto program = ParseProgram(lexer);
+    // Выполняет программу и ожидает завершения запущенных ею задач. Ошибка программы прерывает
+    // ожидание каналов в задачах
+    void ExecuteWithTasks(const runtime::Executable& program, runtime::Closure& closure, runtime::Context& context,
+        runtime::TaskScheduler& scheduler) {
+        try {
+            program.Execute(closure, context);
+        }
+        catch (...) {
+            scheduler.Cancel(current_exception());
+        }
+        scheduler.Wait();
+    }
 
-        runtime::SimpleContext context{ output };
+    // Если heap_profile не nullptr, в него выводится отчёт профилировщика кучи. Отчёт строится
+    // до уничтожения глобальных переменных программы, поэтому учитывает и их. max_call_depth -
+    // предел глубины вызовов методов программы и её задач, 0 - без ограничения
+    void ExecuteProgram(runtime::Executable& program, ostream& output, ostream* heap_profile, size_t max_call_depth) {
+        runtime::TaskScheduler scheduler{ output };
+        scheduler.GetContext().SetMaxCallDepth(max_call_depth);
+        runtime::ProfilingContext profiling_context{ scheduler.GetContext() };
+        runtime::Context& context = heap_profile ? static_cast<runtime::Context&>(profiling_context)
+                                                 : scheduler.GetContext();
         runtime::Closure closure;
-        program->Execute(closure, context);
+        ExecuteWithTasks(program, closure, context, scheduler);
+
+        if (heap_profile) {
+            profiling_context.GetHeapProfiler()->Report(*heap_profile);
+        }
+    }
+
+    void RunMythonProgram(parse::Lexer& lexer, ostream& output, ostream* heap_profile = nullptr,
+        size_t max_call_depth = 0) {
+        auto program = ParseProgram(lexer);
+        ExecuteProgram(*program, output, heap_profile, max_call_depth);
+    }
+
+    void RunMythonProgram(istream& input, ostream& output, ostream* heap_profile = nullptr,
+        size_t max_call_depth = 0) {
+        parse::Lexer lexer(input, parse::Lexer::Mode::Streaming);
+        RunMythonProgram(lexer, output, heap_profile, max_call_depth);
+    }
+
+    // Выполняет программу, разбирая тела методов при их первом вызове
+    void RunLazyMythonProgram(unique_ptr<parse::Lexer> lexer, ostream& output, ostream* heap_profile = nullptr,
+        size_t max_call_depth = 0) {
+        auto program = ParseLazyProgram(std::move(lexer));
+        ExecuteProgram(*program, output, heap_profile, max_call_depth);
+    }
+
+    // Выполняет программу из файла path. Если cache_dir не nullptr, разобранная программа берётся
+    // из кэша (при пустом cache_dir - из файла рядом с программой), а если кэш отсутствует или
+    // устарел, программа разбирается и записывается в него
+    void RunMythonFile(const string& path, const string* cache_dir, ostream& output,
+        ostream* heap_profile = nullptr, size_t max_call_depth = 0) {
+        auto file = make_shared<const parse::MappedFile>(path);
+        if (!cache_dir) {
+            // Большие файлы разбираются на лексемы в нескольких потоках
+            parse::Lexer lexer(file, parse::Lexer::ParallelOptions{});
+            RunMythonProgram(lexer, output, heap_profile, max_call_depth);
+            return;
+        }
+
+        const uint64_t source_hash = flat_ast::ProgramCache::HashSource(file->GetText());
+        const string cache_path = flat_ast::ProgramCache::GetCachePath(path, *cache_dir, source_hash);
+        unique_ptr<runtime::Executable> program = flat_ast::ProgramCache::Load(cache_path, source_hash);
+        if (!program) {
+            parse::Lexer lexer(file, parse::Lexer::ParallelOptions{});
+            program = ParseFlatProgram(lexer);
+            // Кэш лишь ускоряет следующие запуски, поэтому ошибка его записи не прерывает выполнение
+            try {
+                // ParseFlatProgram всегда строит flat_ast::Program
+                flat_ast::ProgramCache::Save(static_cast<const flat_ast::Program&>(*program), source_hash, cache_path);
+            }
+            catch (const runtime_error&) {
+            }
+        }
+        ExecuteProgram(*program, output, heap_profile, max_call_depth);
+    }
+
+    // Выполняет программу из файла path один раз, а затем вызывает метод entry для каждой строки
+    // стандартного ввода
+    void RunMythonFilePerLine(const string& path, string_view entry, ostream& output, size_t max_call_depth) {
+        const parse::MappedFile file(path);
+        const mython::CompiledProgram program = mython::Compile(file.GetText());
+        // Без синхронизации с stdio у cin есть свой буфер, и RunPerRecord узнаёт через in_avail,
+        // что строк больше нет и вывод пора сбросить. Вызывается до первого чтения из cin
+        ios::sync_with_stdio(false);
+        runtime::TaskScheduler scheduler{ output };
+        scheduler.GetContext().SetMaxCallDepth(max_call_depth);
+        try {
+            mython::RunPerRecord(program, scheduler.GetContext(), entry, cin);
+        }
+        catch (...) {
+            scheduler.Cancel(current_exception());
+        }
+        scheduler.Wait();
+    }
+
+    // Выполняет программу из файла path, начиная со снимка snapshot_path состояния после пролога -
+    // части программы до строки Snapshot::MARKER. Если снимка нет или пролог изменился, пролог
+    // выполняется, а снимок записывается заново
+    void RunMythonFileWithSnapshot(const string& path, const string& snapshot_path, ostream& output,
+        size_t max_call_depth) {
+        auto file = make_shared<const parse::MappedFile>(path);
+        const auto parts = flat_ast::Snapshot::SplitSource(file->GetText());
+        if (!parts) {
+            throw runtime_error("Program "s + path + " has no "s + string(flat_ast::Snapshot::MARKER) + " line"s);
+        }
+        const auto [prelude_text, rest_text] = *parts;
+
+        const uint64_t prelude_hash = flat_ast::ProgramCache::HashSource(prelude_text);
+        auto snapshot = flat_ast::Snapshot::Load(snapshot_path, prelude_hash);
+        if (!snapshot) {
+            snapshot.emplace();
+            istringstream prelude_input{ string(prelude_text) };
+            parse::Lexer lexer(prelude_input);
+            // ParseFlatProgram всегда строит flat_ast::Program
+            snapshot->prelude.reset(static_cast<flat_ast::Program*>(ParseFlatProgram(lexer).release()));
+
+            ostringstream prelude_output;
+            runtime::SimpleContext context{ prelude_output };
+            context.SetMaxCallDepth(max_call_depth);
+            snapshot->prelude->Execute(snapshot->globals, context);
+            snapshot->output = prelude_output.str();
+            // Снимок лишь ускоряет следующие запуски, поэтому ошибка его записи не прерывает выполнение
+            try {
+                snapshot->Save(prelude_hash, snapshot_path);
+            }
+            catch (const runtime_error&) {
+            }
+        }
+        output << snapshot->output;
+
+        istringstream rest_input{ string(rest_text) };
+        parse::Lexer lexer(rest_input);
+        auto program = ParseProgramWithClasses(lexer, snapshot->GetClasses());
+        runtime::TaskScheduler scheduler{ output };
+        scheduler.GetContext().SetMaxCallDepth(max_call_depth);
+        ExecuteWithTasks(*program, snapshot->globals, scheduler.GetContext(), scheduler);
     }
 
     void TestSimplePrints() {
@@ -111,6 +273,43 @@ print y.value
         ASSERT_EQUAL(output.str(), "2\n3\n");
     }
 
+    void TestHeapProfile() {
+        istringstream input(R"(
+class Point:
+  def __init__(x):
+    self.x = x
+
+p = Point(1)
+q = Point(2)
+r = Point(3)
+r = None
+print p.x + q.x
+)");
+
+        ostringstream output;
+        ostringstream profile;
+        RunMythonProgram(input, output, &profile);
+
+        ASSERT_EQUAL(output.str(), "3\n"s);
+        const string report = profile.str();
+        const size_t line_start = report.rfind('\n', report.find("ClassInstance Point\n"s)) + 1;
+        istringstream line(report.substr(line_start));
+        size_t live_count, live_bytes, peak_count, peak_bytes, total_count, total_bytes;
+        line >> live_count >> live_bytes >> peak_count >> peak_bytes >> total_count >> total_bytes;
+        ASSERT_EQUAL(live_count, 2U);
+        ASSERT_EQUAL(peak_count, 3U);
+        ASSERT_EQUAL(total_count, 3U);
+        ASSERT_EQUAL(total_bytes, 3 * sizeof(runtime::ClassInstance));
+        ASSERT(report.find("Number at Add #1\n"s) != string::npos);
+
+        // Места размещения названы без адресов, поэтому отчёт повторного запуска совпадает
+        istringstream repeated_input(input.str());
+        ostringstream repeated_output;
+        ostringstream repeated_profile;
+        RunMythonProgram(repeated_input, repeated_output, &repeated_profile);
+        ASSERT_EQUAL(repeated_profile.str(), report);
+    }
+
     void TestAll() {
         TestRunner tr;
         parse::RunOpenLexerTests(tr);
@@ -118,20 +317,140 @@ print y.value
         runtime::RunObjectsTests(tr);
         ast::RunUnitTests(tr);
         TestParseProgram(tr);
+        flat_ast::RunProgramCacheTests(tr);
+        flat_ast::RunSnapshotTests(tr);
+        mython::RunMythonTests(tr);
+        mython::RunBatchTests(tr);
+        runtime::RunTasksTests(tr);
+        runtime::RunGeneratorTests(tr);
+        runtime::RunAsyncOutputTests(tr);
+        mython::RunServerTests(tr);
+        flat_ast::RunLaneEvaluatorTests(tr);
+        runtime::RunExecutionBudgetTests(tr);
 
         RUN_TEST(tr, TestSimplePrints);
         RUN_TEST(tr, TestAssignments);
         RUN_TEST(tr, TestArithmetics);
         RUN_TEST(tr, TestVariablesArePointers);
+        RUN_TEST(tr, TestHeapProfile);
     }
 
 }  // namespace
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
-        TestAll();
-
-        RunMythonProgram(cin, cout);
+        // --test: выполнить тесты интерпретатора вместо программы
+        if (argc == 2 && argv[1] == "--test"sv) {
+            TestAll();
+            return 0;
+        }
+
+        // --heap-profile: по завершении программы вывести в stderr отчёт о размещениях в куче.
+        // Если указан путь к файлу, программа читается из него, иначе из стандартного ввода.
+        // Разобранная программа из файла кэшируется рядом с ним либо в каталоге --cache-dir DIR,
+        // --no-cache отключает кэш. --lazy-methods: разбирать тела методов при первом вызове,
+        // кэш при этом не используется. --snapshot FILE: начинать выполнение программы из файла
+        // со снимка FILE состояния после строки #snapshot, при отсутствии снимка - записать его.
+        // --check FILE...: только проверить синтаксис файлов в --jobs N потоках, не выполняя их.
+        // --serve SOCKET: работать сервером на Unix-сокете SOCKET с --jobs N рабочими потоками;
+        // --max-steps N ограничивает каждый запрос N шагами выполнения.
+        // --max-call-depth N: прерывать программу ошибкой, если вызовы методов вложены глубже N
+        // уровней. По умолчанию глубина не ограничена, а у сервера с --max-steps ограничена
+        // Context::DEFAULT_MAX_CALL_DEPTH.
+        // --per-line OBJECT.METHOD: выполнить программу из файла один раз, а затем вызвать метод
+        // для каждой строки стандартного ввода
+        bool heap_profile = false;
+        bool check = false;
+        size_t jobs = 0;
+        uint64_t max_steps = 0;
+        size_t max_call_depth = 0;
+        vector<string> paths;
+        bool use_cache = true;
+        bool lazy_methods = false;
+        string cache_dir;
+        string snapshot_path;
+        string socket_path;
+        string entry;
+        string path;
+        for (int i = 1; i < argc; ++i) {
+            if (argv[i] == "--heap-profile"sv) {
+                heap_profile = true;
+            }
+            else if (argv[i] == "--no-cache"sv) {
+                use_cache = false;
+            }
+            else if (argv[i] == "--lazy-methods"sv) {
+                lazy_methods = true;
+            }
+            else if (argv[i] == "--check"sv) {
+                check = true;
+            }
+            else if (argv[i] == "--jobs"sv && i + 1 < argc) {
+                jobs = stoul(argv[++i]);
+            }
+            else if (argv[i] == "--cache-dir"sv && i + 1 < argc) {
+                cache_dir = argv[++i];
+            }
+            else if (argv[i] == "--snapshot"sv && i + 1 < argc) {
+                snapshot_path = argv[++i];
+            }
+            else if (argv[i] == "--serve"sv && i + 1 < argc) {
+                socket_path = argv[++i];
+            }
+            else if (argv[i] == "--max-steps"sv && i + 1 < argc) {
+                max_steps = stoull(argv[++i]);
+            }
+            else if (argv[i] == "--max-call-depth"sv && i + 1 < argc) {
+                max_call_depth = stoul(argv[++i]);
+            }
+            else if (argv[i] == "--per-line"sv && i + 1 < argc) {
+                entry = argv[++i];
+            }
+            else {
+                path = argv[i];
+                paths.push_back(path);
+            }
+        }
+        if (check) {
+            const parse::CheckReport report = parse::CheckFiles(paths, jobs);
+            parse::PrintCheckReport(report, cout);
+            return report.error_count == 0 ? 0 : 1;
+        }
+        if (!socket_path.empty()) {
+            mython::Server server({ socket_path, jobs, 256, max_steps, max_call_depth });
+            server.Run();
+            return 0;
+        }
+        // Вывод программы записывается в stdout фоновым потоком. При ошибке контекст
+        // уничтожается до вывода сообщения, поэтому вывод программы предшествует ему
+        runtime::AsyncOutputContext output{ fileno(stdout) };
+        ostream& out = output.GetOutputStream();
+        if (!entry.empty()) {
+            if (path.empty()) {
+                throw runtime_error("--per-line requires a program file"s);
+            }
+            RunMythonFilePerLine(path, entry, out, max_call_depth);
+        }
+        else if (!snapshot_path.empty()) {
+            if (path.empty()) {
+                throw runtime_error("--snapshot requires a program file"s);
+            }
+            RunMythonFileWithSnapshot(path, snapshot_path, out, max_call_depth);
+        }
+        else if (lazy_methods) {
+            auto lexer = path.empty()
+                ? make_unique<parse::Lexer>(cin)
+                : make_unique<parse::Lexer>(make_shared<const parse::MappedFile>(path), parse::Lexer::ParallelOptions{});
+            RunLazyMythonProgram(std::move(lexer), out, heap_profile ? &cerr : nullptr, max_call_depth);
+        }
+        else if (path.empty()) {
+            RunMythonProgram(cin, out, heap_profile ? &cerr : nullptr, max_call_depth);
+        }
+        else {
+            RunMythonFile(path, use_cache ? &cache_dir : nullptr, out, heap_profile ? &cerr : nullptr,
+                max_call_depth);
+        }
+        output.Flush();
     }
     catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
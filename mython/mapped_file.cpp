@@ -0,0 +1,71 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace parse {
+
+#ifdef _WIN32
+
+    MappedFile::MappedFile(const std::string& path) {
+        ifstream file(path, ios::binary);
+        if (!file) {
+            throw runtime_error("Can't open file "s + path);
+        }
+        buffer_.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    MappedFile::~MappedFile() = default;
+
+#else
+
+    MappedFile::MappedFile(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Can't open file "s + path + ": "s + strerror(errno));
+        }
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            const int error = errno;
+            close(fd);
+            throw runtime_error("Can't stat file "s + path + ": "s + strerror(error));
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        //    ,     
+        if (size_ > 0) {
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                close(fd);
+                throw runtime_error("Can't map file "s + path + ": "s + strerror(error));
+            }
+            madvise(data, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(data);
+        }
+        close(fd);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+#endif
+
+}  // namespace parse
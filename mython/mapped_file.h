@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace parse {
+
+    // ,      .  ,   .
+    //    mmap     
+    class MappedFile {
+    public:
+        //  std::runtime_error,       
+        explicit MappedFile(const std::string& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile();
+
+        [[nodiscard]] std::string_view GetText() const {
+            return { data_, size_ };
+        }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        //  ,     
+        std::string buffer_;
+    };
+
+}  // namespace parse
@@ -0,0 +1,178 @@
+#include "mython.h"
+
+#include "execution_budget.h"
+#include "lexer.h"
+#include "parse.h"
+
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace mython {
+
+    CompiledProgram Compile(std::string_view source) {
+        istringstream input{ string(source) };
+        parse::Lexer lexer(input);
+        //          ast
+        return CompiledProgram(ParseFlatProgram(lexer));
+    }
+
+    runtime::Closure Run(const CompiledProgram& program, runtime::Context& context, runtime::Closure inputs) {
+        program.program_->Execute(inputs, context);
+        return inputs;
+    }
+
+    size_t RunPerRecord(const CompiledProgram& program, runtime::Context& context, std::string_view entry,
+        std::istream& input, runtime::Closure inputs) {
+        const size_t dot = entry.find('.');
+        if (dot == string_view::npos) {
+            throw runtime_error("Entry method must be given as object.method"s);
+        }
+        const string object_name(entry.substr(0, dot));
+        const string method(entry.substr(dot + 1));
+
+        program.program_->Execute(inputs, context);
+        const auto it = inputs.find(object_name);
+        runtime::ClassInstance* object = it == inputs.end() ? nullptr : it->second.TryAs<runtime::ClassInstance>();
+        if (!object || !object->HasMethod(method, 1)) {
+            throw runtime_error("Program has no object "s + object_name + " with method "s + method
+                + " of one argument"s);
+        }
+
+        //      ,      
+        const runtime::ObjectHolder holder = it->second;
+        ostream& output = context.GetOutputStream();
+        vector<runtime::ObjectHolder> args(1);
+        string line;
+        size_t count = 0;
+        while (true) {
+            //         ,  
+            //        
+            if (input.rdbuf()->in_avail() <= 0) {
+                output.flush();
+            }
+            if (!getline(input, line)) {
+                break;
+            }
+            ++count;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            args[0] = runtime::ObjectHolder::Own(runtime::String(std::move(line)));
+            try {
+                const runtime::ObjectHolder result = object->Call(method, args, context);
+                if (result) {
+                    result->Print(output, context);
+                    output << '\n';
+                }
+            }
+            catch (const exception& e) {
+                throw runtime_error("Line "s + to_string(count) + ": "s + e.what());
+            }
+            line.clear();
+        }
+        return count;
+    }
+
+    class SuspendableRun::Budget : public runtime::ExecutionBudget {
+    public:
+        Budget(SuspendableRun& run, uint64_t limit, uint64_t slice)
+            : ExecutionBudget(limit, slice)
+            , run_(run) {
+        }
+
+    protected:
+        void OnSlice() override {
+            run_.Suspend();
+        }
+
+    private:
+        SuspendableRun& run_;
+    };
+
+    SuspendableRun::SuspendableRun(CompiledProgram program, runtime::Context& context, uint64_t slice, uint64_t limit,
+        runtime::Closure inputs)
+        : program_(std::move(program))
+        , context_(context)
+        , globals_(std::move(inputs))
+        , budget_(make_unique<Budget>(*this, limit, slice)) {
+    }
+
+    SuspendableRun::~SuspendableRun() {
+        {
+            lock_guard lock(mutex_);
+            cancelled_ = true;
+        }
+        turn_changed_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    SuspendableRun::State SuspendableRun::RunSlice() {
+        unique_lock lock(mutex_);
+        if (state_ != State::Suspended) {
+            return state_;
+        }
+        running_ = true;
+        if (thread_.joinable()) {
+            turn_changed_.notify_all();
+        }
+        else {
+            thread_ = thread([this] {
+                Execute();
+            });
+        }
+        turn_changed_.wait(lock, [this] {
+            return !running_;
+        });
+        return state_;
+    }
+
+    uint64_t SuspendableRun::GetUsedSteps() const {
+        return budget_->GetUsed();
+    }
+
+    void SuspendableRun::Execute() {
+        State state = State::Finished;
+        exception_ptr error;
+        runtime::ExecutionBudget* previous = context_.GetExecutionBudget();
+        const size_t previous_depth = context_.GetMaxCallDepth();
+        context_.SetExecutionBudget(budget_.get());
+        if (previous_depth == 0) {
+            context_.SetMaxCallDepth(runtime::Context::DEFAULT_MAX_CALL_DEPTH);
+        }
+        try {
+            globals_ = Run(program_, context_, std::move(globals_));
+        }
+        catch (...) {
+            state = State::Failed;
+            error = current_exception();
+        }
+        context_.SetExecutionBudget(previous);
+        context_.SetMaxCallDepth(previous_depth);
+
+        lock_guard lock(mutex_);
+        state_ = state;
+        error_ = std::move(error);
+        running_ = false;
+        turn_changed_.notify_all();
+    }
+
+    void SuspendableRun::Suspend() {
+        unique_lock lock(mutex_);
+        running_ = false;
+        turn_changed_.notify_all();
+        turn_changed_.wait(lock, [this] {
+            return running_ || cancelled_;
+        });
+        if (cancelled_) {
+            throw runtime::BudgetExceededError("Execution cancelled"s);
+        }
+    }
+
+}  // namespace mython
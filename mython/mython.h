@@ -0,0 +1,167 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+//      :    , 
+//     ,        
+namespace mython {
+
+    //  .      ,  
+    // CompiledProgram   ,      .
+    //           
+    class CompiledProgram {
+    private:
+        friend CompiledProgram Compile(std::string_view source);
+        friend runtime::Closure Run(const CompiledProgram& program, runtime::Context& context, runtime::Closure inputs);
+        friend size_t RunPerRecord(const CompiledProgram& program, runtime::Context& context, std::string_view entry,
+            std::istream& input, runtime::Closure inputs);
+
+        explicit CompiledProgram(std::shared_ptr<runtime::Executable> program)
+            : program_(std::move(program)) {
+        }
+
+        std::shared_ptr<runtime::Executable> program_;
+    };
+
+    //   .   - ParseError  parse::LexerError
+    CompiledProgram Compile(std::string_view source);
+
+    //  ,     inputs,   
+    //   .  print   context.   -
+    // std::runtime_error.         
+    //  .   - , ,    -
+    //    ,       
+    // CompiledProgram
+    runtime::Closure Run(const CompiledProgram& program, runtime::Context& context, runtime::Closure inputs = {});
+
+    //  :    ,      input
+    //   entry  "."   .  
+    //    ,  ,   ,    None, 
+    //  .       ,   
+    //  ,      .    input  
+    // ,     (flush),      
+    // .    .
+    //        ,  std::runtime_error  
+    // ,     -   
+    size_t RunPerRecord(const CompiledProgram& program, runtime::Context& context, std::string_view entry,
+        std::istream& input, runtime::Closure inputs = {});
+
+    //    :   ,   .
+    //         ,   
+    //    ,    ,     .
+    //    
+    class Isolate {
+    public:
+        explicit Isolate(CompiledProgram program)
+            : program_(std::move(program)) {
+        }
+
+        //      ,       
+        Isolate(const Isolate&) = delete;
+        Isolate& operator=(const Isolate&) = delete;
+
+        //       inputs.  
+        void Run(runtime::Closure inputs = {}) {
+            globals_ = mython::Run(program_, context_, std::move(inputs));
+        }
+
+        [[nodiscard]] const runtime::Closure& GetGlobals() const {
+            return globals_;
+        }
+
+        //       
+        std::string TakeOutput() {
+            std::string output = output_.str();
+            output_.str({});
+            return output;
+        }
+
+    private:
+        CompiledProgram program_;
+        std::ostringstream output_;
+        runtime::SimpleContext context_{ output_ };
+        runtime::Closure globals_;
+    };
+
+    //     ,     
+    // .     ,    
+    // : RunSlice    ,      slice  (.
+    // runtime::ExecutionBudget)   .     
+    //  ,     .     
+    //  ,  limit      (0 -  ). 
+    //     ,     
+    // runtime::Context::DEFAULT_MAX_CALL_DEPTH.   
+    class SuspendableRun {
+    public:
+        enum class State {
+            Suspended,
+            Finished,
+            Failed,
+        };
+
+        //        RunSlice
+        SuspendableRun(CompiledProgram program, runtime::Context& context, uint64_t slice, uint64_t limit = 0,
+            runtime::Closure inputs = {});
+        //     runtime::BudgetExceededError  
+        //   
+        ~SuspendableRun();
+
+        SuspendableRun(const SuspendableRun&) = delete;
+        SuspendableRun& operator=(const SuspendableRun&) = delete;
+
+        //    .       
+        State RunSlice();
+
+        [[nodiscard]] State GetState() const {
+            return state_;
+        }
+
+        //     
+        [[nodiscard]] const runtime::Closure& GetGlobals() const {
+            return globals_;
+        }
+
+        // ,      Failed
+        [[nodiscard]] std::exception_ptr GetError() const {
+            return error_;
+        }
+
+        [[nodiscard]] uint64_t GetUsedSteps() const;
+
+    private:
+        class Budget;
+
+        //   
+        void Execute();
+        //         RunSlice
+        void Suspend();
+
+        CompiledProgram program_;
+        runtime::Context& context_;
+        runtime::Closure globals_;
+        std::unique_ptr<Budget> budget_;
+
+        std::mutex mutex_;
+        std::condition_variable turn_changed_;
+        //     
+        bool running_ = false;
+        bool cancelled_ = false;
+        State state_ = State::Suspended;
+        std::exception_ptr error_;
+        std::thread thread_;
+    };
+
+}  // namespace mython
@@ -0,0 +1,330 @@
+#include "execution_budget.h"
+#include "lexer.h"
+#include "mython.h"
+#include "parse.h"
+#include "test_runner_p.h"
+
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace mython {
+
+    namespace {
+
+        void TestEmbedding() {
+            const mython::CompiledProgram program = mython::Compile(R"(
+class Greeter:
+  def __init__(greeting):
+    self.greeting = greeting
+
+  def greet(name):
+    return self.greeting + ", " + name
+
+greeter = Greeter(prefix)
+result = greeter.greet(name)
+print result
+)"sv);
+
+            //       ,      
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            const runtime::Closure first = mython::Run(program, context,
+                { { "prefix"s, runtime::ObjectHolder::Own(runtime::String("Hello"s)) },
+                    { "name"s, runtime::ObjectHolder::Own(runtime::String("world"s)) } });
+            const runtime::Closure second = mython::Run(program, context,
+                { { "prefix"s, runtime::ObjectHolder::Own(runtime::String("Bye"s)) },
+                    { "name"s, runtime::ObjectHolder::Own(runtime::String("Mython"s)) } });
+            ASSERT_EQUAL(output.str(), "Hello, world\nBye, Mython\n"s);
+            ASSERT_EQUAL(first.at("result"s).TryAs<runtime::String>()->GetValue(), "Hello, world"s);
+            ASSERT_EQUAL(second.at("result"s).TryAs<runtime::String>()->GetValue(), "Bye, Mython"s);
+            //     ,     
+            ASSERT(first.at("Greeter"s).Get() == second.at("Greeter"s).Get());
+
+            //       
+            ASSERT_THROWS(mython::Run(program, context), runtime_error);
+            ASSERT_THROWS(mython::Compile("x = \n"sv), parse::LexerError);
+            ASSERT_THROWS(mython::Compile("x = Missing()\n"sv), ParseError);
+        }
+
+        void TestValuesOutliveProgram() {
+            // , ,       , 
+            //     CompiledProgram
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            runtime::ObjectHolder message;
+            runtime::ObjectHolder greeter;
+            runtime::ObjectHolder numbers;
+            {
+                const runtime::Closure globals = mython::Run(mython::Compile(R"(
+class Greeter:
+  def greet(name):
+    return "Hello, " + name
+
+  def count(n):
+    yield n
+    yield n + 1
+
+message = "constant"
+greeter = Greeter()
+numbers = greeter.count(1)
+)"sv), context);
+                message = globals.at("message"s);
+                greeter = globals.at("greeter"s);
+                numbers = globals.at("numbers"s);
+            }
+            //   ,    ,    
+            mython::Run(mython::Compile("greeter.label = \"field\"\n"sv), context, { { "greeter"s, greeter } });
+            ASSERT(message.IsOwning());
+            auto* instance = greeter.TryAs<runtime::ClassInstance>();
+            instance->Fields().at("label"s)->Print(output, context);
+            output << '\n';
+            message->Print(output, context);
+            output << '\n';
+            instance->Call("greet"s, { runtime::ObjectHolder::Own(runtime::String("world"s)) }, context)
+                ->Print(output, context);
+            output << '\n';
+            numbers->Print(output, context);
+            output << '\n';
+            instance->Call("count"s, { runtime::ObjectHolder::Own(runtime::Number(5)) }, context)->Print(output, context);
+            ASSERT_EQUAL(output.str(), "field\nconstant\nHello, world\n1 2\n5 6"s);
+        }
+
+        void TestIsolates() {
+            const mython::CompiledProgram program = mython::Compile(R"(
+class Fib:
+  def calc(n):
+    if n < 2:
+      return n
+    return self.calc(n - 1) + self.calc(n - 2)
+
+class Accumulator:
+  def __init__():
+    self.text = ""
+
+  def add(value):
+    self.text = self.text + str(value) + " "
+
+fib = Fib()
+acc = Accumulator()
+acc.add(fib.calc(n))
+acc.add(fib.calc(n + 1))
+print "fib", acc.text
+)"sv);
+
+            //     ,      
+            constexpr int ISOLATE_COUNT = 4;
+            constexpr int RUN_COUNT = 20;
+            vector<unique_ptr<mython::Isolate>> isolates;
+            for (int i = 0; i < ISOLATE_COUNT; ++i) {
+                isolates.push_back(make_unique<mython::Isolate>(program));
+            }
+            vector<thread> threads;
+            for (int i = 0; i < ISOLATE_COUNT; ++i) {
+                threads.emplace_back([&isolate = *isolates[i], i] {
+                    for (int run = 0; run < RUN_COUNT; ++run) {
+                        isolate.Run({ { "n"s, runtime::ObjectHolder::Own(runtime::Number(i + 5)) } });
+                    }
+                });
+            }
+            for (thread& worker : threads) {
+                worker.join();
+            }
+
+            const vector<string> expected = { "fib 5 8 \n"s, "fib 8 13 \n"s, "fib 13 21 \n"s, "fib 21 34 \n"s };
+            for (int i = 0; i < ISOLATE_COUNT; ++i) {
+                string expected_output;
+                for (int run = 0; run < RUN_COUNT; ++run) {
+                    expected_output += expected[i];
+                }
+                ASSERT_EQUAL(isolates[i]->TakeOutput(), expected_output);
+                ASSERT(isolates[i]->GetGlobals().at("Fib"s).Get() == isolates[0]->GetGlobals().at("Fib"s).Get());
+                ASSERT(isolates[i]->GetGlobals().at("acc"s).Get() != isolates[(i + 1) % ISOLATE_COUNT]->GetGlobals().at("acc"s).Get());
+            }
+        }
+
+        //     ,   :     ,
+        //   
+        class LineByLineBuffer : public streambuf {
+        public:
+            explicit LineByLineBuffer(vector<string> lines)
+                : lines_(std::move(lines)) {
+            }
+
+        protected:
+            int_type underflow() override {
+                if (next_ == lines_.size()) {
+                    return traits_type::eof();
+                }
+                current_ = lines_[next_++];
+                setg(current_.data(), current_.data(), current_.data() + current_.size());
+                return traits_type::to_int_type(current_.front());
+            }
+
+        private:
+            vector<string> lines_;
+            size_t next_ = 0;
+            string current_;
+        };
+
+        class CountingFlushBuffer : public stringbuf {
+        public:
+            size_t flush_count = 0;
+
+        protected:
+            int sync() override {
+                ++flush_count;
+                return stringbuf::sync();
+            }
+        };
+
+        void TestPerRecord() {
+            const mython::CompiledProgram program = mython::Compile(R"(
+class Counter:
+  def __init__():
+    self.count = 0
+
+class Handler:
+  def __init__(counter):
+    self.counter = counter
+
+  def handle(line):
+    self.counter.count = self.counter.count + 1
+    if line == "skip":
+      return None
+    if line == "print":
+      print "printed"
+      return None
+    return str(self.counter.count) + ": " + line
+
+counter = Counter()
+handler = Handler(counter)
+print "prelude"
+)"sv);
+            //    ,      
+            istringstream input("first\r\nskip\nprint\nlast"s);
+            ostringstream output;
+            runtime::SimpleContext context{ output };
+            ASSERT_EQUAL(mython::RunPerRecord(program, context, "handler.handle"sv, input), 4u);
+            ASSERT_EQUAL(output.str(), "prelude\n1: first\nprinted\n4: last\n"s);
+
+            //      ,  ,   
+            // ,     
+            CountingFlushBuffer counted;
+            ostream counted_output(&counted);
+            runtime::SimpleContext counted_context{ counted_output };
+            LineByLineBuffer interactive({ "a\n"s, "b\n"s });
+            istream interactive_input(&interactive);
+            ASSERT_EQUAL(mython::RunPerRecord(program, counted_context, "handler.handle"sv, interactive_input), 2u);
+            ASSERT_EQUAL(counted.flush_count, 3u);
+            ASSERT_EQUAL(counted.str(), "prelude\n1: a\n2: b\n"s);
+            counted.flush_count = 0;
+            istringstream buffered("c\nd\n"s);
+            mython::RunPerRecord(program, counted_context, "handler.handle"sv, buffered);
+            ASSERT_EQUAL(counted.flush_count, 1u);
+
+            istringstream empty;
+            ASSERT_THROWS(mython::RunPerRecord(program, context, "handler.missing"sv, empty), runtime_error);
+            ASSERT_THROWS(mython::RunPerRecord(program, context, "nobody.handle"sv, empty), runtime_error);
+            ASSERT_THROWS(mython::RunPerRecord(program, context, "handle"sv, empty), runtime_error);
+
+            //     
+            const mython::CompiledProgram failing = mython::Compile(R"(
+class Parser:
+  def parse(line):
+    return 1 / 0
+
+parser = Parser()
+)"sv);
+            istringstream lines("a\nb\n"s);
+            try {
+                mython::RunPerRecord(failing, context, "parser.parse"sv, lines);
+                ASSERT(false);
+            }
+            catch (const runtime_error& e) {
+                ASSERT_EQUAL(string(e.what()).substr(0, 8), "Line 1: "s);
+            }
+        }
+
+        void TestSuspendableRun() {
+            const mython::CompiledProgram program = mython::Compile(R"(
+class Counter:
+  def count(n):
+    if n > 0:
+      print n
+      self.count(n - 1)
+
+c = Counter()
+c.count(limit)
+)"sv);
+            //       10 
+            ostringstream first_output;
+            ostringstream second_output;
+            runtime::SimpleContext first_context{ first_output };
+            runtime::SimpleContext second_context{ second_output };
+            runtime::Closure first_inputs;
+            first_inputs["limit"s] = runtime::ObjectHolder::Own(runtime::Number(30));
+            runtime::Closure second_inputs;
+            second_inputs["limit"s] = runtime::ObjectHolder::Own(runtime::Number(3));
+            mython::SuspendableRun first(program, first_context, 10, 0, std::move(first_inputs));
+            mython::SuspendableRun second(program, second_context, 10, 0, std::move(second_inputs));
+            ASSERT(first.RunSlice() == mython::SuspendableRun::State::Suspended);
+            // ,    ,  
+            ASSERT_EQUAL(first.GetUsedSteps(), 11u);
+            ASSERT(second.RunSlice() == mython::SuspendableRun::State::Suspended);
+            ASSERT(second.RunSlice() == mython::SuspendableRun::State::Finished);
+            size_t slices = 1;
+            while (first.RunSlice() == mython::SuspendableRun::State::Suspended) {
+                ++slices;
+            }
+            ASSERT(first.GetState() == mython::SuspendableRun::State::Finished);
+            ASSERT(slices > 5);
+            ASSERT_EQUAL(second_output.str(), "3\n2\n1\n"s);
+            ASSERT_EQUAL(first_output.str().substr(0, 9), "30\n29\n28\n"s);
+            ASSERT(first.GetGlobals().count("limit"s));
+            ASSERT(!first_context.GetExecutionBudget());
+
+            //      
+            ostringstream limited_output;
+            runtime::SimpleContext limited_context{ limited_output };
+            runtime::Closure limited_inputs;
+            limited_inputs["limit"s] = runtime::ObjectHolder::Own(runtime::Number(100));
+            mython::SuspendableRun limited(program, limited_context, 10, 25, std::move(limited_inputs));
+            while (limited.RunSlice() == mython::SuspendableRun::State::Suspended) {
+            }
+            ASSERT(limited.GetState() == mython::SuspendableRun::State::Failed);
+            ASSERT_THROWS(rethrow_exception(limited.GetError()), runtime::BudgetExceededError);
+
+            //     
+            ostringstream endless_output;
+            runtime::SimpleContext endless_context{ endless_output };
+            {
+                mython::SuspendableRun endless(mython::Compile(R"(
+class Runaway:
+  def loop(n):
+    return self.loop(n + 1)
+
+r = Runaway()
+r.loop(0)
+)"sv), endless_context, 100);
+                ASSERT(endless.RunSlice() == mython::SuspendableRun::State::Suspended);
+            }
+        }
+
+    }  // namespace
+
+    void RunMythonTests(TestRunner& tr) {
+        RUN_TEST(tr, mython::TestEmbedding);
+        RUN_TEST(tr, mython::TestValuesOutliveProgram);
+        RUN_TEST(tr, mython::TestIsolates);
+        RUN_TEST(tr, mython::TestPerRecord);
+        RUN_TEST(tr, mython::TestSuspendableRun);
+    }
+
+}  // namespace mython
@@ -1,8 +1,14 @@
 #include "parse.h"
 
+#include "flat_ast.h"
 #include "lexer.h"
 #include "statement.h"
 
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 using namespace std;
 
 namespace TokenType = parse::token_type;
@@ -17,41 +23,230 @@ namespace {
         return !(token == c);
     }
 
+    //      ast
+    class AstBuilder {
+    public:
+        using Node = unique_ptr<ast::Statement>;
+
+        Node NumericConst(int value) {
+            return make_unique<ast::NumericConst>(value);
+        }
+        Node StringConst(string value) {
+            return make_unique<ast::StringConst>(std::move(value));
+        }
+        Node BoolConst(bool value) {
+            return make_unique<ast::BoolConst>(runtime::Bool(value));
+        }
+        Node None() {
+            return make_unique<ast::None>();
+        }
+        Node VariableValue(vector<string> dotted_ids) {
+            return make_unique<ast::VariableValue>(std::move(dotted_ids));
+        }
+        Node Assignment(string var, Node rv) {
+            return make_unique<ast::Assignment>(std::move(var), std::move(rv));
+        }
+        Node FieldAssignment(vector<string> object, string field_name, Node rv) {
+            return make_unique<ast::FieldAssignment>(ast::VariableValue{ std::move(object) },
+                std::move(field_name), std::move(rv));
+        }
+        Node Print(vector<Node> args) {
+            return make_unique<ast::Print>(std::move(args));
+        }
+        Node MethodCall(Node object, string method, vector<Node> args) {
+            return make_unique<ast::MethodCall>(std::move(object), std::move(method), std::move(args));
+        }
+        Node NewInstance(const runtime::Class& cls, vector<Node> args) {
+            return make_unique<ast::NewInstance>(cls, std::move(args));
+        }
+        Node Stringify(Node argument) {
+            return make_unique<ast::Stringify>(std::move(argument));
+        }
+        Node Add(Node lhs, Node rhs) {
+            return make_unique<ast::Add>(std::move(lhs), std::move(rhs));
+        }
+        Node Sub(Node lhs, Node rhs) {
+            return make_unique<ast::Sub>(std::move(lhs), std::move(rhs));
+        }
+        Node Mult(Node lhs, Node rhs) {
+            return make_unique<ast::Mult>(std::move(lhs), std::move(rhs));
+        }
+        Node Div(Node lhs, Node rhs) {
+            return make_unique<ast::Div>(std::move(lhs), std::move(rhs));
+        }
+        Node Or(Node lhs, Node rhs) {
+            return make_unique<ast::Or>(std::move(lhs), std::move(rhs));
+        }
+        Node And(Node lhs, Node rhs) {
+            return make_unique<ast::And>(std::move(lhs), std::move(rhs));
+        }
+        Node Not(Node argument) {
+            return make_unique<ast::Not>(std::move(argument));
+        }
+        Node Comparison(ast::Comparison::Comparator cmp, Node lhs, Node rhs) {
+            return make_unique<ast::Comparison>(std::move(cmp), std::move(lhs), std::move(rhs));
+        }
+        Node Compound(vector<Node> statements) {
+            auto result = make_unique<ast::Compound>();
+            for (auto& statement : statements) {
+                result->AddStatement(std::move(statement));
+            }
+            return result;
+        }
+        Node Return(Node statement) {
+            return make_unique<ast::Return>(std::move(statement));
+        }
+        Node Yield(Node statement, bool delegate) {
+            return make_unique<ast::Yield>(std::move(statement), delegate);
+        }
+        Node ClassDefinition(runtime::ObjectHolder cls) {
+            return make_unique<ast::ClassDefinition>(std::move(cls));
+        }
+        Node IfElse(Node condition, Node if_body, Node else_body) {
+            return make_unique<ast::IfElse>(std::move(condition), std::move(if_body), std::move(else_body));
+        }
+        Node Spawn(Node object, string method, vector<Node> args) {
+            return make_unique<ast::Spawn>(std::move(object), std::move(method), std::move(args));
+        }
+        Node NewChannel(Node capacity) {
+            return make_unique<ast::NewChannel>(std::move(capacity));
+        }
+
+        unique_ptr<runtime::Executable> MethodBody(Node body) {
+            return make_unique<ast::MethodBody>(std::move(body));
+        }
+        unique_ptr<runtime::Executable> Program(Node body) {
+            return body;
+        }
+    };
+
+    // ,   ,     
+    struct DeclaredClass {
+        const runtime::Class* cls;
+        size_t index;
+    };
+
+    using DeclaredClasses = unordered_map<string, DeclaredClass>;
+
+    //    ,       .
+    //    ,       
+    struct LazySource {
+        unique_ptr<parse::Lexer> lexer;
+        DeclaredClasses declared_classes;
+        mutex lexer_mutex;
+    };
+
+    //  ,     .    , 
+    //  ,      
+    class LazyMethodBody : public runtime::Executable {
+    public:
+        LazyMethodBody(shared_ptr<LazySource> source, size_t position, size_t visible_classes)
+            : source_(std::move(source))
+            , position_(position)
+            , visible_classes_(visible_classes) {
+        }
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
+
+    private:
+        //     
+        const runtime::Executable& GetBody() const;
+
+        //        parsed_,   
+        //     .     
+        mutable shared_ptr<LazySource> source_;
+        size_t position_;
+        size_t visible_classes_;
+        mutable once_flag parsed_;
+        mutable unique_ptr<runtime::Executable> body_;
+    };
+
+    // Builder    : AstBuilder  flat_ast::Builder.
+    //  Node,    ,   
+    template <typename Builder>
     class Parser {
     public:
+        using Node = typename Builder::Node;
+
         explicit Parser(parse::Lexer& lexer)
-            : lexer_(lexer) {
+            : lexer_(lexer)
+            , declared_classes_(make_shared<DeclaredClasses>()) {
+        }
+
+        //   ,      classes. , 
+        //  ,   new_classes,    nullptr
+        Parser(parse::Lexer& lexer, const KnownClasses& classes, vector<runtime::ObjectHolder>* new_classes)
+            : Parser(lexer) {
+            known_classes_ = &classes;
+            new_classes_ = new_classes;
+        }
+
+        // ,    ,      
+        explicit Parser(shared_ptr<LazySource> source)
+            : lexer_(*source->lexer)
+            , declared_classes_(source, &source->declared_classes)
+            , lazy_source_(std::move(source)) {
+        }
+
+        //   ,    .    
+        // visible_classes  
+        Parser(const shared_ptr<LazySource>& source, size_t visible_classes)
+            : lexer_(*source->lexer)
+            , declared_classes_(source, &source->declared_classes)
+            , visible_classes_(visible_classes) {
         }
 
         // Program -> eps
         //          | Statement \n Program
-        unique_ptr<ast::Statement> ParseProgram() {
-            auto result = make_unique<ast::Compound>();
+        unique_ptr<runtime::Executable> ParseProgram() {
+            vector<Node> statements;
             while (!lexer_.CurrentToken().Is<TokenType::Eof>()) {
-                result->AddStatement(ParseStatement());
+                statements.push_back(ParseStatement());
             }
 
-            return result;
+            return builder_.Program(builder_.Compound(std::move(statements)));
+        }
+
+        // Method -> def id(Params) : Suite EOF
+        runtime::Method ParseMethod() {
+            lexer_.Expect<TokenType::Def>();
+            vector<runtime::Method> methods = ParseMethods();
+            lexer_.Expect<TokenType::Eof>();
+            if (methods.size() != 1) {
+                throw ParseError("Exactly one method definition is expected"s);
+            }
+            return std::move(methods.front());
+        }
+
+        //   ,      position
+        Node ParseSuiteAt(size_t position) {
+            lexer_.SetPosition(position);
+            //       
+            bool is_generator = false;
+            method_is_generator_ = &is_generator;
+            return ParseSuite();
         }
 
     private:
         // Suite -> NEWLINE INDENT (Statement)+ DEDENT
-        unique_ptr<ast::Statement> ParseSuite()  // NOLINT
+        Node ParseSuite()  // NOLINT
         {
             lexer_.Expect<TokenType::Newline>();
             lexer_.ExpectNext<TokenType::Indent>();
 
             lexer_.NextToken();
 
-            auto result = make_unique<ast::Compound>();
+            vector<Node> statements;
             while (!lexer_.CurrentToken().Is<TokenType::Dedent>()) {
-                result->AddStatement(ParseStatement());  // NOLINT
+                statements.push_back(ParseStatement());  // NOLINT
             }
 
             lexer_.Expect<TokenType::Dedent>();
             lexer_.NextToken();
 
-            return result;
+            return builder_.Compound(std::move(statements));
         }
 
         // Methods -> [def id(Params) : Suite]*
@@ -76,15 +271,64 @@ namespace {
                 lexer_.ExpectNext<TokenType::Char>(':');
                 lexer_.NextToken();
 
-                m.body = std::make_unique<ast::MethodBody>(ParseSuite());  // NOLINT
+                bool* const outer_method = std::exchange(method_is_generator_, &m.is_generator);
+                m.body = lazy_source_ ? SkipMethodBody(m.is_generator) : builder_.MethodBody(ParseSuite());  // NOLINT
+                method_is_generator_ = outer_method;
 
                 result.push_back(std::move(m));
             }
             return result;
         }
 
+        //      Dedent,    . ,  
+        //  ,  ,         .
+        //     yield,  is_generator
+        unique_ptr<runtime::Executable> SkipMethodBody(bool& is_generator) {
+            const size_t position = lexer_.GetPosition();
+            lexer_.Expect<TokenType::Newline>();
+            lexer_.ExpectNext<TokenType::Indent>();
+
+            for (int depth = 1; depth > 0;) {
+                lexer_.NextToken();
+                const auto& tok = lexer_.CurrentToken();
+                if (tok.Is<TokenType::Indent>()) {
+                    ++depth;
+                }
+                else if (tok.Is<TokenType::Dedent>()) {
+                    --depth;
+                }
+                else if (tok.Is<TokenType::Yield>()) {
+                    is_generator = true;
+                }
+                else if (tok.Is<TokenType::Class>()) {
+                    lexer_.SetPosition(position);
+                    return builder_.MethodBody(ParseSuite());  // NOLINT
+                }
+                else if (tok.Is<TokenType::Eof>()) {
+                    lexer_.Expect<TokenType::Dedent>();
+                }
+            }
+            lexer_.NextToken();
+
+            return make_unique<LazyMethodBody>(lazy_source_, position, declared_classes_->size());
+        }
+
+        //   name,       ,  nullptr
+        const runtime::Class* FindClass(const string& name) const {
+            if (known_classes_) {
+                if (auto it = known_classes_->find(name); it != known_classes_->end()) {
+                    return it->second;
+                }
+            }
+            auto it = declared_classes_->find(name);
+            if (it == declared_classes_->end() || it->second.index >= visible_classes_) {
+                return nullptr;
+            }
+            return it->second.cls;
+        }
+
         // ClassDefinition -> Id ['(' Id ')'] : new_line indent MethodList dedent
-        unique_ptr<ast::Statement> ParseClassDefinition()  // NOLINT
+        Node ParseClassDefinition()  // NOLINT
         {
             string class_name = lexer_.Expect<TokenType::Id>().value;
 
@@ -96,11 +340,10 @@ namespace {
                 lexer_.ExpectNext<TokenType::Char>(')');
                 lexer_.NextToken();
 
-                auto it = declared_classes_.find(name);
-                if (it == declared_classes_.end()) {
+                base_class = FindClass(name);
+                if (!base_class) {
                     throw ParseError("Base class "s + name + " not found for class "s + class_name);
                 }
-                base_class = static_cast<const runtime::Class*>(it->second.Get());  // NOLINT
             }
 
             lexer_.Expect<TokenType::Char>(':');
@@ -112,16 +355,17 @@ namespace {
             lexer_.Expect<TokenType::Dedent>();
             lexer_.NextToken();
 
-            auto [it, inserted] = declared_classes_.insert({
-                class_name,
-                runtime::ObjectHolder::Own(runtime::Class(class_name, std::move(methods), base_class)),
-                });
-
-            if (!inserted) {
+            auto cls = runtime::ObjectHolder::Own(runtime::Class(class_name, std::move(methods), base_class));
+            const DeclaredClass declared{ cls.TryAs<runtime::Class>(), declared_classes_->size() };
+            if ((known_classes_ && known_classes_->count(class_name) != 0)
+                || !declared_classes_->emplace(class_name, declared).second) {
                 throw ParseError("Class "s + class_name + " already exists"s);
             }
+            if (new_classes_) {
+                new_classes_->push_back(cls);
+            }
 
-            return make_unique<ast::ClassDefinition>(it->second);
+            return builder_.ClassDefinition(std::move(cls));
         }
 
         vector<string> ParseDottedIds() {
@@ -136,7 +380,7 @@ namespace {
 
         //  AssgnOrCall -> DottedIds = Expr
         //               | DottedIds '(' ExprList ')'
-        unique_ptr<ast::Statement> ParseAssignmentOrCall() {
+        Node ParseAssignmentOrCall() {
             lexer_.Expect<TokenType::Id>();
 
             vector<string> id_list = ParseDottedIds();
@@ -147,10 +391,9 @@ namespace {
                 lexer_.NextToken();
 
                 if (id_list.empty()) {
-                    return make_unique<ast::Assignment>(std::move(last_name), ParseTest());
+                    return builder_.Assignment(std::move(last_name), ParseTest());
                 }
-                return make_unique<ast::FieldAssignment>(ast::VariableValue{ std::move(id_list) },
-                    std::move(last_name), ParseTest());
+                return builder_.FieldAssignment(std::move(id_list), std::move(last_name), ParseTest());
             }
             lexer_.Expect<TokenType::Char>('(');
             lexer_.NextToken();
@@ -159,48 +402,48 @@ namespace {
                 throw ParseError("Mython doesn't support functions, only methods: "s + last_name);
             }
 
-            vector<unique_ptr<ast::Statement>> args;
+            vector<Node> args;
             if (lexer_.CurrentToken() != ')') {
                 args = ParseTestList();
             }
             lexer_.Expect<TokenType::Char>(')');
             lexer_.NextToken();
 
-            return make_unique<ast::MethodCall>(make_unique<ast::VariableValue>(std::move(id_list)),
-                std::move(last_name), std::move(args));
+            return builder_.MethodCall(builder_.VariableValue(std::move(id_list)), std::move(last_name),
+                std::move(args));
         }
 
         // Expr -> Adder ['+'/'-' Adder]*
-        unique_ptr<ast::Statement> ParseExpression()  // NOLINT
+        Node ParseExpression()  // NOLINT
         {
-            unique_ptr<ast::Statement> result = ParseAdder();
+            Node result = ParseAdder();
             while (lexer_.CurrentToken() == '+' || lexer_.CurrentToken() == '-') {
                 char op = lexer_.CurrentToken().As<TokenType::Char>().value;
                 lexer_.NextToken();
 
                 if (op == '+') {
-                    result = make_unique<ast::Add>(std::move(result), ParseAdder());
+                    result = builder_.Add(std::move(result), ParseAdder());
                 }
                 else {
-                    result = make_unique<ast::Sub>(std::move(result), ParseAdder());
+                    result = builder_.Sub(std::move(result), ParseAdder());
                 }
             }
             return result;
         }
 
         // Adder -> Mult ['*'/'/' Mult]*
-        unique_ptr<ast::Statement> ParseAdder()  // NOLINT
+        Node ParseAdder()  // NOLINT
         {
-            unique_ptr<ast::Statement> result = ParseMult();
+            Node result = ParseMult();
             while (lexer_.CurrentToken() == '*' || lexer_.CurrentToken() == '/') {
                 char op = lexer_.CurrentToken().As<TokenType::Char>().value;
                 lexer_.NextToken();
 
                 if (op == '*') {
-                    result = make_unique<ast::Mult>(std::move(result), ParseMult());
+                    result = builder_.Mult(std::move(result), ParseMult());
                 }
                 else {
-                    result = make_unique<ast::Div>(std::move(result), ParseMult());
+                    result = builder_.Div(std::move(result), ParseMult());
                 }
             }
             return result;
@@ -215,7 +458,7 @@ namespace {
         //       | FALSE
         //       | DottedIds '(' ExprList ')'
         //       | DottedIds
-        unique_ptr<ast::Statement> ParseMult()  // NOLINT
+        Node ParseMult()  // NOLINT
         {
             if (lexer_.CurrentToken() == '(') {
                 lexer_.NextToken();
@@ -226,40 +469,40 @@ namespace {
             }
             if (lexer_.CurrentToken() == '-') {
                 lexer_.NextToken();
-                return make_unique<ast::Mult>(ParseMult(), make_unique<ast::NumericConst>(-1));
+                return builder_.Mult(ParseMult(), builder_.NumericConst(-1));
             }
             if (const auto* num = lexer_.CurrentToken().TryAs<TokenType::Number>()) {
                 int result = num->value;
                 lexer_.NextToken();
-                return make_unique<ast::NumericConst>(result);
+                return builder_.NumericConst(result);
             }
             if (const auto* str = lexer_.CurrentToken().TryAs<TokenType::String>()) {
                 string result = str->value;
                 lexer_.NextToken();
-                return make_unique<ast::StringConst>(std::move(result));
+                return builder_.StringConst(std::move(result));
             }
             if (lexer_.CurrentToken().Is<TokenType::True>()) {
                 lexer_.NextToken();
-                return make_unique<ast::BoolConst>(runtime::Bool(true));
+                return builder_.BoolConst(true);
             }
             if (lexer_.CurrentToken().Is<TokenType::False>()) {
                 lexer_.NextToken();
-                return make_unique<ast::BoolConst>(runtime::Bool(false));
+                return builder_.BoolConst(false);
             }
             if (lexer_.CurrentToken().Is<TokenType::None>()) {
                 lexer_.NextToken();
-                return make_unique<ast::None>();
+                return builder_.None();
             }
 
             return ParseDottedIdsInMultExpr();
         }
 
-        std::unique_ptr<ast::Statement> ParseDottedIdsInMultExpr() {
+        Node ParseDottedIdsInMultExpr() {
             vector<string> names = ParseDottedIds();
 
             if (lexer_.CurrentToken() == '(') {
                 // various calls
-                vector<unique_ptr<ast::Statement>> args;
+                vector<Node> args;
                 if (lexer_.NextToken() != ')') {
                     args = ParseTestList();
                 }
@@ -270,28 +513,32 @@ namespace {
                 names.pop_back();
 
                 if (!names.empty()) {
-                    return make_unique<ast::MethodCall>(
-                        make_unique<ast::VariableValue>(std::move(names)), std::move(method_name),
-                        std::move(args));
+                    return builder_.MethodCall(builder_.VariableValue(std::move(names)),
+                        std::move(method_name), std::move(args));
                 }
-                if (auto it = declared_classes_.find(method_name); it != declared_classes_.end()) {
-                    return make_unique<ast::NewInstance>(
-                        static_cast<const runtime::Class&>(*it->second), std::move(args));  // NOLINT
+                if (const runtime::Class* cls = FindClass(method_name)) {
+                    return builder_.NewInstance(*cls, std::move(args));
                 }
                 if (method_name == "str"sv) {
                     if (args.size() != 1) {
                         throw ParseError("Function str takes exactly one argument"s);
                     }
-                    return make_unique<ast::Stringify>(std::move(args.front()));
+                    return builder_.Stringify(std::move(args.front()));
+                }
+                if (method_name == "Channel"sv) {
+                    if (args.size() != 1) {
+                        throw ParseError("Function Channel takes exactly one argument"s);
+                    }
+                    return builder_.NewChannel(std::move(args.front()));
                 }
                 throw ParseError("Unknown call to "s + method_name + "()"s);
             }
-            return make_unique<ast::VariableValue>(std::move(names));
+            return builder_.VariableValue(std::move(names));
         }
 
-        vector<unique_ptr<ast::Statement>> ParseTestList()  // NOLINT
+        vector<Node> ParseTestList()  // NOLINT
         {
-            vector<unique_ptr<ast::Statement>> result;
+            vector<Node> result;
             result.push_back(ParseTest());
 
             while (lexer_.CurrentToken() == ',') {
@@ -302,7 +549,7 @@ namespace {
         }
 
         // Condition -> if LogicalExpr: Suite [else: Suite]
-        unique_ptr<ast::Statement> ParseCondition()  // NOLINT
+        Node ParseCondition()  // NOLINT
         {
             lexer_.Expect<TokenType::If>();
             lexer_.NextToken();
@@ -314,52 +561,51 @@ namespace {
 
             auto if_body = ParseSuite();
 
-            unique_ptr<ast::Statement> else_body;
+            Node else_body;
             if (lexer_.CurrentToken().Is<TokenType::Else>()) {
                 lexer_.ExpectNext<TokenType::Char>(':');
                 lexer_.NextToken();
                 else_body = ParseSuite();
             }
 
-            return make_unique<ast::IfElse>(std::move(condition), std::move(if_body),
-                std::move(else_body));
+            return builder_.IfElse(std::move(condition), std::move(if_body), std::move(else_body));
         }
 
         // LogicalExpr -> AndTest [OR AndTest]
         // AndTest -> NotTest [AND NotTest]
         // NotTest -> [NOT] NotTest
         //          | Comparison
-        unique_ptr<ast::Statement> ParseTest()  // NOLINT
+        Node ParseTest()  // NOLINT
         {
             auto result = ParseAndTest();
             while (lexer_.CurrentToken().Is<TokenType::Or>()) {
                 lexer_.NextToken();
-                result = make_unique<ast::Or>(std::move(result), ParseAndTest());
+                result = builder_.Or(std::move(result), ParseAndTest());
             }
             return result;
         }
 
-        unique_ptr<ast::Statement> ParseAndTest()  // NOLINT
+        Node ParseAndTest()  // NOLINT
         {
             auto result = ParseNotTest();
             while (lexer_.CurrentToken().Is<TokenType::And>()) {
                 lexer_.NextToken();
-                result = make_unique<ast::And>(std::move(result), ParseNotTest());
+                result = builder_.And(std::move(result), ParseNotTest());
             }
             return result;
         }
 
-        unique_ptr<ast::Statement> ParseNotTest()  // NOLINT
+        Node ParseNotTest()  // NOLINT
         {
             if (lexer_.CurrentToken().Is<TokenType::Not>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Not>(ParseNotTest());  // NOLINT
+                return builder_.Not(ParseNotTest());  // NOLINT
             }
             return ParseComparison();
         }
 
         // Comparison -> Expr [COMP_OP Expr]
-        unique_ptr<ast::Statement> ParseComparison()  // NOLINT
+        Node ParseComparison()  // NOLINT
         {
             auto result = ParseExpression();
 
@@ -367,32 +613,32 @@ namespace {
 
             if (tok == '<') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Less, std::move(result),
+                return builder_.Comparison(runtime::Less, std::move(result),
                     ParseExpression());
             }
             if (tok == '>') {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Greater, std::move(result),
+                return builder_.Comparison(runtime::Greater, std::move(result),
                     ParseExpression());
             }
             if (tok.Is<TokenType::Eq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::Equal, std::move(result),
+                return builder_.Comparison(runtime::Equal, std::move(result),
                     ParseExpression());
             }
             if (tok.Is<TokenType::NotEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::NotEqual, std::move(result),
+                return builder_.Comparison(runtime::NotEqual, std::move(result),
                     ParseExpression());
             }
             if (tok.Is<TokenType::LessOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::LessOrEqual, std::move(result),
+                return builder_.Comparison(runtime::LessOrEqual, std::move(result),
                     ParseExpression());
             }
             if (tok.Is<TokenType::GreaterOrEq>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Comparison>(runtime::GreaterOrEqual, std::move(result),
+                return builder_.Comparison(runtime::GreaterOrEqual, std::move(result),
                     ParseExpression());
             }
             return result;
@@ -401,7 +647,7 @@ namespace {
         // Statement -> SimpleStatement Newline
         //           | class ClassDefinition
         //           | if Condition
-        unique_ptr<ast::Statement> ParseStatement()  // NOLINT
+        Node ParseStatement()  // NOLINT
         {
             const auto& tok = lexer_.CurrentToken();
 
@@ -419,32 +665,124 @@ namespace {
         }
 
         // StatementBody -> return Expression
+        //               | yield [from] Expression
         //               | print ExpressionList
+        //               | spawn DottedIds(ExpressionList)
         //               | AssignmentOrCall
-        unique_ptr<ast::Statement> ParseSimpleStatement() {
+        Node ParseSimpleStatement() {
             const auto& tok = lexer_.CurrentToken();
 
+            if (tok.Is<TokenType::Spawn>()) {
+                lexer_.NextToken();
+                return ParseSpawn();
+            }
+
             if (tok.Is<TokenType::Return>()) {
                 lexer_.NextToken();
-                return make_unique<ast::Return>(ParseTest());
+                return builder_.Return(ParseTest());
+            }
+            if (tok.Is<TokenType::Yield>()) {
+                if (!method_is_generator_) {
+                    throw ParseError("yield outside a method"s);
+                }
+                *method_is_generator_ = true;
+                //  from  yield  yield from,   from
+                //   
+                lexer_.NextToken();
+                const auto* from = lexer_.CurrentToken().TryAs<TokenType::Id>();
+                const bool delegate = from != nullptr && from->value == "from"sv;
+                if (delegate) {
+                    lexer_.NextToken();
+                }
+                return builder_.Yield(ParseTest(), delegate);
             }
             if (tok.Is<TokenType::Print>()) {
                 lexer_.NextToken();
-                vector<unique_ptr<ast::Statement>> args;
+                vector<Node> args;
                 if (!lexer_.CurrentToken().Is<TokenType::Newline>()) {
                     args = ParseTestList();
                 }
-                return make_unique<ast::Print>(std::move(args));
+                return builder_.Print(std::move(args));
             }
             return ParseAssignmentOrCall();
         }
 
+        // Spawn -> DottedIds(ExpressionList),  DottedIds -    
+        Node ParseSpawn() {
+            vector<string> names = ParseDottedIds();
+            if (names.size() < 2) {
+                throw ParseError("spawn requires a method call object.method(...)"s);
+            }
+            lexer_.Expect<TokenType::Char>('(');
+            vector<Node> args;
+            if (lexer_.NextToken() != ')') {
+                args = ParseTestList();
+            }
+            lexer_.Expect<TokenType::Char>(')');
+            lexer_.NextToken();
+
+            string method_name = std::move(names.back());
+            names.pop_back();
+            return builder_.Spawn(builder_.VariableValue(std::move(names)), std::move(method_name), std::move(args));
+        }
+
         parse::Lexer& lexer_;
-        runtime::Closure declared_classes_;
+        Builder builder_;
+        //  .           
+        shared_ptr<DeclaredClasses> declared_classes_;
+        size_t visible_classes_ = numeric_limits<size_t>::max();
+        //        nullptr,    
+        shared_ptr<LazySource> lazy_source_;
+        // ,     ,     
+        const KnownClasses* known_classes_ = nullptr;
+        vector<runtime::ObjectHolder>* new_classes_ = nullptr;
+        //       nullptr  
+        bool* method_is_generator_ = nullptr;
     };
 
+    const runtime::Executable& LazyMethodBody::GetBody() const {
+        call_once(parsed_, [this] {
+            {
+                lock_guard lock(source_->lexer_mutex);
+                Parser<AstBuilder> parser(source_, visible_classes_);
+                body_ = AstBuilder{}.MethodBody(parser.ParseSuiteAt(position_));
+            }
+            source_.reset();
+        });
+        return *body_;
+    }
+
+    runtime::ObjectHolder LazyMethodBody::Execute(runtime::Closure& closure, runtime::Context& context) const {
+        return GetBody().Execute(closure, context);
+    }
+
+    runtime::ObjectHolder LazyMethodBody::Resume(runtime::Closure& closure, runtime::Context& context,
+        runtime::GeneratorFrame& frame) const {
+        return GetBody().Resume(closure, context, frame);
+    }
+
 }  // namespace
 
 unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer) {
-    return Parser{ lexer }.ParseProgram();
+    return Parser<AstBuilder>{ lexer }.ParseProgram();
+}
+
+unique_ptr<runtime::Executable> ParseFlatProgram(parse::Lexer& lexer) {
+    return Parser<flat_ast::Builder>{ lexer }.ParseProgram();
+}
+
+unique_ptr<runtime::Executable> ParseProgramWithClasses(parse::Lexer& lexer,
+    const KnownClasses& classes, vector<runtime::ObjectHolder>* new_classes) {
+    return Parser<AstBuilder>{ lexer, classes, new_classes }.ParseProgram();
+}
+
+runtime::Method ParseMethod(parse::Lexer& lexer, const KnownClasses& classes,
+    vector<runtime::ObjectHolder>* new_classes) {
+    return Parser<AstBuilder>{ lexer, classes, new_classes }.ParseMethod();
+}
+
+unique_ptr<runtime::Executable> ParseLazyProgram(unique_ptr<parse::Lexer> lexer) {
+    auto source = make_shared<LazySource>();
+    source->lexer = std::move(lexer);
+    return Parser<AstBuilder>{ std::move(source) }.ParseProgram();
 }
@@ -2,17 +2,47 @@
 
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace parse {
     class Lexer;
 }
 
 namespace runtime {
+    class Class;
     class Executable;
+    class ObjectHolder;
+    struct Method;
 }
 
+// ,        ,  
+using KnownClasses = std::unordered_map<std::string, const runtime::Class*>;
+
 struct ParseError : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
 std::unique_ptr<runtime::Executable> ParseProgram(parse::Lexer& lexer);
+
+//         flat_ast,    
+//  
+std::unique_ptr<runtime::Executable> ParseFlatProgram(parse::Lexer& lexer);
+
+//     ast,   :    , 
+//  ,        .    ,
+//   ,  .   ,   
+//   ,        Streaming
+std::unique_ptr<runtime::Executable> ParseLazyProgram(std::unique_ptr<parse::Lexer> lexer);
+
+//   ,        classes.
+//      .  new_classes  nullptr,  
+//  ,   
+std::unique_ptr<runtime::Executable> ParseProgramWithClasses(parse::Lexer& lexer,
+    const KnownClasses& classes, std::vector<runtime::ObjectHolder>* new_classes = nullptr);
+
+//     ,    classes:
+// def id(Params) : Suite.  new_classes -   ParseProgramWithClasses
+runtime::Method ParseMethod(parse::Lexer& lexer, const KnownClasses& classes,
+    std::vector<runtime::ObjectHolder>* new_classes = nullptr);
@@ -0,0 +1,105 @@
+#include "parse_check.h"
+
+#include "lexer.h"
+#include "mapped_file.h"
+#include "parse.h"
+#include "runtime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <system_error>
+#include <thread>
+
+using namespace std;
+
+namespace parse {
+
+    CheckResult CheckFile(const std::string& path) {
+        CheckResult result;
+        result.path = path;
+        unique_ptr<Lexer> lexer;
+        try {
+            auto file = make_shared<const MappedFile>(path);
+            result.size = file->GetText().size();
+            //   ,        
+            lexer = make_unique<Lexer>(std::move(file));
+            ParseProgram(*lexer);
+        }
+        catch (const LexerError& e) {
+            //      ,      
+            result.ok = false;
+            result.error = e.what();
+            result.line = e.GetLine() != 0 ? e.GetLine() : lexer ? lexer->GetLine() : 0;
+        }
+        catch (const ParseError& e) {
+            result.ok = false;
+            result.error = e.what();
+            result.line = lexer->GetLine();
+        }
+        catch (const runtime_error& e) {
+            result.ok = false;
+            result.error = e.what();
+        }
+        return result;
+    }
+
+    CheckReport CheckFiles(const std::vector<std::string>& paths, size_t thread_count) {
+        const auto start = chrono::steady_clock::now();
+        if (thread_count == 0) {
+            thread_count = max<size_t>(thread::hardware_concurrency(), 1);
+        }
+
+        CheckReport report;
+        report.files.resize(paths.size());
+        atomic<size_t> next_file{ 0 };
+        auto work = [&] {
+            for (size_t i = next_file++; i < paths.size(); i = next_file++) {
+                report.files[i] = CheckFile(paths[i]);
+            }
+        };
+
+        vector<thread> threads;
+        for (size_t i = 1; i < min(thread_count, paths.size()); ++i) {
+            try {
+                threads.emplace_back(work);
+            }
+            catch (const system_error&) {
+                //    
+                break;
+            }
+        }
+        work();
+        for (thread& worker : threads) {
+            worker.join();
+        }
+
+        for (const CheckResult& result : report.files) {
+            report.error_count += result.ok ? 0 : 1;
+            report.total_size += result.size;
+        }
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+    void PrintCheckReport(const CheckReport& report, std::ostream& output) {
+        for (const CheckResult& result : report.files) {
+            if (result.ok) {
+                continue;
+            }
+            output << result.path << ':';
+            if (result.line != 0) {
+                output << result.line << ':';
+            }
+            output << ' ' << result.error << '\n';
+        }
+        const double megabytes = static_cast<double>(report.total_size) / (1 << 20);
+        const double seconds = max(report.seconds, 1e-9);
+        output << "Checked "sv << report.files.size() << " files ("sv << megabytes << " MB) in "sv
+               << report.seconds * 1000 << " ms: "sv << report.error_count << " with errors, "sv
+               << report.files.size() / seconds << " files/s, "sv << megabytes / seconds << " MB/s"sv << endl;
+    }
+
+}  // namespace parse
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace parse {
+
+    //     
+    struct CheckResult {
+        std::string path;
+        bool ok = true;
+        //          
+        std::string error;
+        //   , 0 -   
+        size_t line = 0;
+        uint64_t size = 0;
+    };
+
+    struct CheckReport {
+        //    ,  CheckFiles
+        std::vector<CheckResult> files;
+        size_t error_count = 0;
+        uint64_t total_size = 0;
+        double seconds = 0;
+    };
+
+    //     path,   
+    CheckResult CheckFile(const std::string& path);
+
+    //   paths  thread_count  (0 -    ).  
+    //      ,    
+    CheckReport CheckFiles(const std::vector<std::string>& paths, size_t thread_count = 0);
+
+    //     ":: "      
+    void PrintCheckReport(const CheckReport& report, std::ostream& output);
+
+}  // namespace parse
@@ -1,16 +1,47 @@
+#include "incremental_program.h"
 #include "lexer.h"
 #include "parse.h"
+#include "parse_check.h"
+#include "program_cache.h"
 #include "statement.h"
 #include "test_runner_p.h"
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 using namespace std;
 
 namespace parse {
 
+    //  ,   .      ,
+    //     ,    
+    unique_ptr<runtime::Executable> (*program_parser)(Lexer&) = ::ParseProgram;
+
+    string GetTestCachePath() {
+        return (filesystem::temp_directory_path() / "mython_parse_test.myc"s).string();
+    }
+
+    //  ,       ,   
+    unique_ptr<runtime::Executable> ParseCachedProgram(Lexer& lexer) {
+        auto program = ::ParseFlatProgram(lexer);
+        const string path = GetTestCachePath();
+        flat_ast::ProgramCache::Save(static_cast<const flat_ast::Program&>(*program), 1, path);
+        auto loaded = flat_ast::ProgramCache::Load(path, 1);
+        ASSERT(loaded != nullptr);
+        filesystem::remove(path);
+        return loaded;
+    }
+
+    //  ,    .     
+    unique_ptr<runtime::Executable> ParseLazyProgram(Lexer& lexer) {
+        return ::ParseLazyProgram(make_unique<Lexer>(std::move(lexer)));
+    }
+
     unique_ptr<ast::Statement> ParseProgramFromString(const string& program) {
         istringstream is(program);
         parse::Lexer lexer(is);
-        return ParseProgram(lexer);
+        return program_parser(lexer);
     }
 
     void TestSimpleProgram() {
@@ -266,16 +297,296 @@ x = X(xh)
         ASSERT_EQUAL(xh->Fields().at("x"s).Get(), closure.at("x"s).Get());
     }
 
+    unique_ptr<runtime::Executable> ParseLazyProgramFromString(const string& program) {
+        istringstream is(program);
+        return ::ParseLazyProgram(make_unique<Lexer>(is));
+    }
+
+    void TestLazyMethodBodies() {
+        const string program = R"(
+class Lib:
+  def used():
+    return 1
+  def unused():
+    return Missing()
+
+x = Lib()
+y = x.used()
+)"s;
+
+        //    ,   ,    
+        try {
+            ParseProgramFromString(program);
+            ASSERT(false);
+        }
+        catch (const ParseError&) {
+        }
+
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        auto tree = ParseLazyProgramFromString(program + "z = x.unused()\n"s);
+        try {
+            tree->Execute(closure, context);
+            ASSERT(false);
+        }
+        catch (const ParseError&) {
+        }
+        ASSERT_EQUAL(closure.at("y"s).TryAs<runtime::Number>()->GetValue(), 1);
+        ASSERT(closure.count("z"s) == 0);
+    }
+
+    void TestLazyMethodSeesEarlierClasses() {
+        //     ,     ,   
+        const string program = R"(
+class A:
+  def make():
+    return B()
+
+class B:
+  def value():
+    return 2
+
+a = A()
+b = a.make()
+)"s;
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        auto tree = ParseLazyProgramFromString(program);
+        try {
+            tree->Execute(closure, context);
+            ASSERT(false);
+        }
+        catch (const ParseError&) {
+        }
+
+        // ,    ,      
+        const string nested = R"(
+class Outer:
+  def define():
+    class Inner:
+      def value():
+        return 3
+    return 0
+
+inner = Inner()
+v = inner.value()
+)"s;
+        closure.clear();
+        ParseLazyProgramFromString(nested)->Execute(closure, context);
+        ASSERT_EQUAL(closure.at("v"s).TryAs<runtime::Number>()->GetValue(), 3);
+    }
+
+    void TestIncrementalMethodEdit() {
+        const string program = R"(
+class Shape:
+  def area():
+    return 0
+
+  def name():
+    return "shape"
+
+class Square(Shape):
+  def __init__(side):
+    self.side = side
+
+  def area():
+    return self.side * self.side
+
+square = Square(3)
+total = square.area()
+)"s;
+        IncrementalProgram incremental(program);
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        incremental.Execute(closure, context);
+        ASSERT_EQUAL(closure.at("total"s).TryAs<runtime::Number>()->GetValue(), 9);
+
+        //      ,      
+        string edited = program;
+        edited.replace(edited.find("self.side * self.side"s), "self.side * self.side"s.size(), "self.side * 4"s);
+        auto stats = incremental.Update(edited);
+        ASSERT_EQUAL(stats.methods, 1u);
+        ASSERT_EQUAL(stats.statements, 0u);
+        ASSERT(!stats.full);
+        auto* square = closure.at("square"s).TryAs<runtime::ClassInstance>();
+        ASSERT_EQUAL(square->Call("area"s, {}, context).TryAs<runtime::Number>()->GetValue(), 12);
+
+        //      ,    
+        edited.replace(edited.find("class Square"s), 0, "  def sides():\n    return 4\n\n"s);
+        stats = incremental.Update(edited);
+        ASSERT_EQUAL(stats.methods, 1u);
+        ASSERT(!stats.full);
+        ASSERT_EQUAL(square->Call("sides"s, {}, context).TryAs<runtime::Number>()->GetValue(), 4);
+        ASSERT_EQUAL(square->Call("name"s, {}, context).TryAs<runtime::String>()->GetValue(), "shape"sv);
+
+        //       
+        edited.replace(edited.find("Square(3)"s), "Square(3)"s.size(), "Square(5)"s);
+        stats = incremental.Update(edited);
+        ASSERT_EQUAL(stats.statements, 1u);
+        ASSERT_EQUAL(stats.methods, 0u);
+        closure.clear();
+        incremental.Execute(closure, context);
+        ASSERT_EQUAL(closure.at("total"s).TryAs<runtime::Number>()->GetValue(), 20);
+        ASSERT_EQUAL(incremental.GetSource(), edited);
+    }
+
+    void TestIncrementalGeneratorEdit() {
+        const string program = "class Counter:\n  def count(n):\n    yield n\n    yield n + 1\n    yield n + 2\n\n"
+            "c = Counter()\ng = c.count(1)\n"s;
+        IncrementalProgram incremental(program);
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        incremental.Execute(closure, context);
+        auto* generator = closure.at("g"s).TryAs<runtime::Generator>();
+        ASSERT_EQUAL(generator->Next(context).TryAs<runtime::Number>()->GetValue(), 1);
+
+        //      ,     
+        string edited = program;
+        edited.replace(edited.find("yield n + 1"s), "yield n + 1"s.size(), "yield n * 10"s);
+        ASSERT_EQUAL(incremental.Update(edited).methods, 1u);
+        ASSERT_EQUAL(generator->Next(context).TryAs<runtime::Number>()->GetValue(), 2);
+        ASSERT_EQUAL(generator->Next(context).TryAs<runtime::Number>()->GetValue(), 3);
+        ASSERT(!generator->HasNext(context));
+
+        const runtime::ObjectHolder edited_generator = closure.at("c"s).TryAs<runtime::ClassInstance>()
+            ->Call("count"s, { runtime::ObjectHolder::Own(runtime::Number(2)) }, context);
+        ostringstream output;
+        edited_generator->Print(output, context);
+        ASSERT_EQUAL(output.str(), "2 20 4"s);
+    }
+
+    void TestIncrementalFullReparse() {
+        const string program = "class A:\n  def f():\n    return 1\n\nx = A()\ny = x.f()\n"s;
+        IncrementalProgram incremental(program);
+        runtime::DummyContext context;
+        runtime::Closure closure;
+        incremental.Execute(closure, context);
+
+        //     
+        try {
+            incremental.Update("class A:\n  def f():\n    return Missing()\n\nx = A()\ny = x.f()\n"s);
+            ASSERT(false);
+        }
+        catch (const ParseError&) {
+        }
+        ASSERT_EQUAL(incremental.GetSource(), program);
+        ASSERT_EQUAL(closure.at("x"s).TryAs<runtime::ClassInstance>()->Call("f"s, {}, context)
+            .TryAs<runtime::Number>()->GetValue(), 1);
+
+        //      .   
+        //  
+        const auto stats = incremental.Update("class B:\n  def f():\n    return 2\n\nx = B()\ny = x.f()\n"s);
+        ASSERT(stats.full);
+        ASSERT_EQUAL(closure.at("x"s).TryAs<runtime::ClassInstance>()->Call("f"s, {}, context)
+            .TryAs<runtime::Number>()->GetValue(), 1);
+        closure.clear();
+        incremental.Execute(closure, context);
+        ASSERT_EQUAL(closure.at("y"s).TryAs<runtime::Number>()->GetValue(), 2);
+    }
+
+    void TestProgramCacheValidation() {
+        istringstream is("x = 1\nprint x\n"s);
+        Lexer lexer(is);
+        auto program = ::ParseFlatProgram(lexer);
+        const auto& flat_program = static_cast<const flat_ast::Program&>(*program);
+        const string path = GetTestCachePath();
+        const uint64_t hash = flat_ast::ProgramCache::HashSource("x = 1\nprint x\n"sv);
+        ASSERT(hash != flat_ast::ProgramCache::HashSource("x = 2\nprint x\n"sv));
+
+        flat_ast::ProgramCache::Save(flat_program, hash, path);
+        ASSERT(flat_ast::ProgramCache::Load(path, hash) != nullptr);
+        // ,     ,  
+        ASSERT(flat_ast::ProgramCache::Load(path, hash + 1) == nullptr);
+
+        //      
+        {
+            fstream file(path, ios::in | ios::out | ios::binary);
+            file.put('X');
+        }
+        ASSERT(flat_ast::ProgramCache::Load(path, hash) == nullptr);
+        flat_ast::ProgramCache::Save(flat_program, hash, path);
+        filesystem::resize_file(path, filesystem::file_size(path) - 1);
+        ASSERT(flat_ast::ProgramCache::Load(path, hash) == nullptr);
+
+        filesystem::remove(path);
+        ASSERT(flat_ast::ProgramCache::Load(path, hash) == nullptr);
+    }
+
+    void TestCheckFiles() {
+        const auto dir = filesystem::temp_directory_path() / "mython_check_test"s;
+        filesystem::create_directories(dir);
+        const vector<pair<string, string>> sources = {
+            { "good.my"s, "class A:\n  def f():\n    return 1\n\nx = A()\nprint x.f()\n"s },
+            { "number.my"s, "x = 1\n\ny = 99999999999\n"s },
+            { "syntax.my"s, "x = 1\nif x\n  print x\n"s },
+            { "base.my"s, "x = 1\n# comment\nclass B(Missing):\n  def f():\n    return 1\n"s },
+        };
+        vector<string> paths;
+        for (const auto& [name, text] : sources) {
+            paths.push_back((dir / name).string());
+            ofstream(paths.back()) << text;
+        }
+        paths.push_back((dir / "missing.my"s).string());
+
+        const CheckReport report = CheckFiles(paths, 3);
+        ASSERT_EQUAL(report.files.size(), paths.size());
+        ASSERT_EQUAL(report.error_count, 4u);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            ASSERT_EQUAL(report.files[i].path, paths[i]);
+        }
+        ASSERT(report.files[0].ok);
+        ASSERT_EQUAL(report.files[1].line, 3u);
+        ASSERT_EQUAL(report.files[1].error, "Number is out of range: 99999999999"s);
+        ASSERT_EQUAL(report.files[2].line, 2u);
+        ASSERT_EQUAL(report.files[3].line, 3u);
+        ASSERT_EQUAL(report.files[3].error, "Base class Missing not found for class B"s);
+        ASSERT(!report.files[4].ok);
+        ASSERT_EQUAL(report.files[4].line, 0u);
+
+        ostringstream output;
+        PrintCheckReport(report, output);
+        ASSERT(output.str().find(paths[2] + ":2: "s) != string::npos);
+        ASSERT(output.str().find("Checked 5 files"s) != string::npos);
+
+        filesystem::remove_all(dir);
+    }
+
 }  // namespace parse
 
+namespace {
+    void RunParseProgramTests(TestRunner& tr) {
+        RUN_TEST(tr, parse::TestSimpleProgram);
+        RUN_TEST(tr, parse::TestProgramWithClasses);
+        RUN_TEST(tr, parse::TestProgramWithIf);
+        RUN_TEST(tr, parse::TestReturnFromIf);
+        RUN_TEST(tr, parse::TestRecursion);
+        RUN_TEST(tr, parse::TestRecursion2);
+        RUN_TEST(tr, parse::TestComplexLogicalExpression);
+        RUN_TEST(tr, parse::TestClassicalPolymorphism);
+        RUN_TEST(tr, parse::TestSelfInConstructor);
+    }
+}  // namespace
+
 void TestParseProgram(TestRunner& tr) {
-    RUN_TEST(tr, parse::TestSimpleProgram);
-    RUN_TEST(tr, parse::TestProgramWithClasses);
-    RUN_TEST(tr, parse::TestProgramWithIf);
-    RUN_TEST(tr, parse::TestReturnFromIf);
-    RUN_TEST(tr, parse::TestRecursion);
-    RUN_TEST(tr, parse::TestRecursion2);
-    RUN_TEST(tr, parse::TestComplexLogicalExpression);
-    RUN_TEST(tr, parse::TestClassicalPolymorphism);
-    RUN_TEST(tr, parse::TestSelfInConstructor);
+    parse::program_parser = ::ParseProgram;
+    RunParseProgramTests(tr);
+
+    parse::program_parser = ::ParseFlatProgram;
+    RunParseProgramTests(tr);
+
+    parse::program_parser = parse::ParseCachedProgram;
+    RunParseProgramTests(tr);
+
+    parse::program_parser = parse::ParseLazyProgram;
+    RunParseProgramTests(tr);
+    parse::program_parser = ::ParseProgram;
+
+    RUN_TEST(tr, parse::TestLazyMethodBodies);
+    RUN_TEST(tr, parse::TestLazyMethodSeesEarlierClasses);
+    RUN_TEST(tr, parse::TestIncrementalMethodEdit);
+    RUN_TEST(tr, parse::TestIncrementalGeneratorEdit);
+    RUN_TEST(tr, parse::TestIncrementalFullReparse);
+
+    RUN_TEST(tr, parse::TestProgramCacheValidation);
+    RUN_TEST(tr, parse::TestCheckFiles);
 }
@@ -0,0 +1,334 @@
+#include "program_cache.h"
+
+#include "binary_io.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using binary_io::ALIGNMENT;
+
+namespace flat_ast {
+
+    namespace {
+        //  : ,  ,   (   8 )  
+        //   ,   
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint32_t node_size;
+            uint32_t root;
+            uint64_t source_hash;
+            uint64_t node_count;
+            uint64_t list_count;
+            uint64_t nodes_offset;
+            uint64_t lists_offset;
+            uint64_t data_offset;
+            uint64_t file_size;
+        };
+
+        constexpr char MAGIC[8] = "MYTHONC";
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        static_assert(std::is_trivially_copyable_v<Node>, "Nodes are stored in the cache as is");
+        static_assert(alignof(Node) <= ALIGNMENT && alignof(Header) <= ALIGNMENT);
+
+        // ,       
+        constexpr uint32_t NO_CLASS = NO_NODE;
+    }  // namespace
+
+    uint64_t ProgramCache::HashSource(std::string_view text) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char c : text) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    std::string ProgramCache::GetCachePath(const std::string& source_path, const std::string& cache_dir,
+        uint64_t source_hash) {
+        if (cache_dir.empty()) {
+            return source_path + "c"s;
+        }
+        ostringstream name;
+        name << hex << setw(16) << setfill('0') << source_hash << ".myc"sv;
+        return (filesystem::path(cache_dir) / name.str()).string();
+    }
+
+    std::string ProgramCache::Serialize(const Program& program, uint64_t source_hash) {
+        const Tree& tree = program.GetTree();
+        binary_io::Writer writer;
+        Header header{};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.node_size = sizeof(Node);
+        header.root = program.GetRoot();
+        header.source_hash = source_hash;
+        header.node_count = tree.node_count_;
+        header.list_count = tree.list_count_;
+        writer.Append(&header, sizeof(header));
+
+        header.nodes_offset = writer.Align();
+        writer.Append(tree.nodes_, tree.node_count_ * sizeof(Node));
+        header.lists_offset = writer.Align();
+        writer.Append(tree.lists_, tree.list_count_ * sizeof(uint32_t));
+        header.data_offset = writer.Align();
+
+        writer.Write(static_cast<uint32_t>(tree.names_.size()));
+        for (const string& name : tree.names_) {
+            writer.Write(name);
+        }
+        writer.Write(static_cast<uint32_t>(tree.numbers_.size()));
+        for (const runtime::Number& number : tree.numbers_) {
+            writer.Write(static_cast<uint32_t>(number.GetValue()));
+        }
+        writer.Write(static_cast<uint32_t>(tree.strings_.size()));
+        for (const runtime::String& str : tree.strings_) {
+            writer.Write(str.GetValue());
+        }
+
+        //     ,     
+        unordered_map<const runtime::Class*, uint32_t> class_indices;
+        writer.Write(static_cast<uint32_t>(tree.class_holders_.size()));
+        for (const runtime::ObjectHolder& holder : tree.class_holders_) {
+            const auto* cls = holder.TryAs<runtime::Class>();
+            const auto parent = cls->parent_ ? class_indices.find(cls->parent_) : class_indices.end();
+            if (cls->parent_ && parent == class_indices.end()) {
+                throw logic_error("Parent of class "s + cls->GetName() + " is not defined in the program"s);
+            }
+            writer.Write(cls->GetName());
+            writer.Write(cls->parent_ ? parent->second : NO_CLASS);
+            writer.Write(static_cast<uint32_t>(cls->methods_.size()));
+            for (const runtime::Method& method : cls->methods_) {
+                const auto* body = dynamic_cast<const MethodBody*>(method.body.get());
+                if (!body) {
+                    throw logic_error("Only programs built by flat_ast::Builder can be cached"s);
+                }
+                writer.Write(method.name);
+                writer.Write(static_cast<uint32_t>(method.formal_params.size()));
+                for (const string& param : method.formal_params) {
+                    writer.Write(param);
+                }
+                writer.Write(body->GetBody());
+                writer.Write(static_cast<uint32_t>(method.is_generator));
+            }
+            class_indices.emplace(cls, static_cast<uint32_t>(class_indices.size()));
+        }
+        writer.Write(static_cast<uint32_t>(tree.classes_.size()));
+        for (const runtime::Class* cls : tree.classes_) {
+            const auto it = class_indices.find(cls);
+            if (it == class_indices.end()) {
+                throw logic_error("Class "s + cls->GetName() + " is not defined in the program"s);
+            }
+            writer.Write(it->second);
+        }
+
+        string& data = writer.GetData();
+        header.file_size = data.size();
+        memcpy(data.data(), &header, sizeof(header));
+        return std::move(data);
+    }
+
+    void ProgramCache::Save(const Program& program, uint64_t source_hash, const std::string& path) {
+        binary_io::WriteFileAtomically(path, Serialize(program, source_hash));
+    }
+
+    std::unique_ptr<Program> ProgramCache::Load(const std::string& path, uint64_t source_hash) {
+        try {
+            auto file = make_shared<const parse::MappedFile>(path);
+            const string_view text = file->GetText();
+            return Deserialize(text, std::move(file), source_hash);
+        }
+        catch (const std::runtime_error&) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<Program> ProgramCache::Deserialize(std::string_view text, std::shared_ptr<const void> owner,
+        uint64_t source_hash) {
+        if (reinterpret_cast<uintptr_t>(text.data()) % ALIGNMENT != 0) {
+            return nullptr;
+        }
+        try {
+            Header header;
+            if (text.size() < sizeof(header)) {
+                return nullptr;
+            }
+            memcpy(&header, text.data(), sizeof(header));
+            if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION
+                || header.byte_order != BYTE_ORDER_MARK || header.node_size != sizeof(Node)
+                || header.source_hash != source_hash || header.file_size != text.size()
+                || header.nodes_offset % ALIGNMENT != 0 || header.lists_offset % ALIGNMENT != 0
+                //         ,    
+                || header.nodes_offset < sizeof(header) || header.nodes_offset > header.lists_offset
+                || header.lists_offset > header.data_offset || header.data_offset > text.size()
+                || header.node_count > (header.lists_offset - header.nodes_offset) / sizeof(Node)
+                || header.list_count > (header.data_offset - header.lists_offset) / sizeof(uint32_t)
+                || header.root >= header.node_count) {
+                return nullptr;
+            }
+
+            auto tree = make_shared<Tree>();
+            tree->nodes_ = reinterpret_cast<const Node*>(text.data() + header.nodes_offset);
+            tree->node_count_ = header.node_count;
+            tree->lists_ = reinterpret_cast<const uint32_t*>(text.data() + header.lists_offset);
+            tree->list_count_ = header.list_count;
+
+            binary_io::Reader reader(text.substr(header.data_offset));
+            tree->names_.resize(reader.ReadCount(sizeof(uint32_t)));
+            for (string& name : tree->names_) {
+                name = reader.ReadText();
+            }
+            const uint32_t number_count = reader.ReadCount(sizeof(uint32_t));
+            tree->numbers_.reserve(number_count);
+            for (uint32_t i = 0; i < number_count; ++i) {
+                tree->numbers_.emplace_back(static_cast<int>(reader.ReadU32()));
+            }
+            const uint32_t string_count = reader.ReadCount(sizeof(uint32_t));
+            tree->strings_.reserve(string_count);
+            for (uint32_t i = 0; i < string_count; ++i) {
+                tree->strings_.emplace_back(reader.ReadText());
+            }
+
+            const uint32_t class_count = reader.ReadCount(3 * sizeof(uint32_t));
+            for (uint32_t i = 0; i < class_count; ++i) {
+                string name(reader.ReadText());
+                const uint32_t parent = reader.ReadU32();
+                if (parent != NO_CLASS && parent >= i) {
+                    return nullptr;
+                }
+                vector<runtime::Method> methods(reader.ReadCount(4 * sizeof(uint32_t)));
+                for (runtime::Method& method : methods) {
+                    method.name = reader.ReadText();
+                    method.formal_params.resize(reader.ReadCount(sizeof(uint32_t)));
+                    for (string& param : method.formal_params) {
+                        param = reader.ReadText();
+                    }
+                    const NodeIndex body = reader.ReadU32();
+                    if (body >= header.node_count) {
+                        return nullptr;
+                    }
+                    method.body = make_unique<MethodBody>(*tree, body);
+                    method.is_generator = reader.ReadU32() != 0;
+                }
+                const runtime::Class* parent_class
+                    = parent == NO_CLASS ? nullptr : tree->class_holders_[parent].TryAs<runtime::Class>();
+                tree->class_holders_.push_back(
+                    runtime::ObjectHolder::Own(runtime::Class(std::move(name), std::move(methods), parent_class)));
+            }
+            tree->classes_.resize(reader.ReadCount(sizeof(uint32_t)));
+            for (const runtime::Class*& cls : tree->classes_) {
+                const uint32_t index = reader.ReadU32();
+                if (index >= tree->class_holders_.size()) {
+                    return nullptr;
+                }
+                cls = tree->class_holders_[index].TryAs<runtime::Class>();
+            }
+
+            if (!CheckTree(*tree)) {
+                return nullptr;
+            }
+            tree->storage_owner_ = std::move(owner);
+            return make_unique<Program>(std::move(tree), header.root);
+        }
+        catch (const std::runtime_error&) {
+            return nullptr;
+        }
+    }
+
+    bool ProgramCache::CheckTree(const Tree& tree) {
+        vector<bool> has_parent(tree.node_count_, false);
+        for (NodeIndex index = 0; index < tree.node_count_; ++index) {
+            const Node& node = tree.nodes_[index];
+            const auto is_name = [&tree](uint32_t name) {
+                return name < tree.names_.size();
+            };
+            const auto is_child = [&has_parent, index](NodeIndex child) {
+                if (child >= index || has_parent[child]) {
+                    return false;
+                }
+                has_parent[child] = true;
+                return true;
+            };
+            const bool is_list = node.items <= tree.list_count_ && node.count <= tree.list_count_ - node.items;
+            const uint32_t* list = tree.lists_ + node.items;
+            const auto are_children = [&] {
+                return is_list && all_of(list, list + node.count, is_child);
+            };
+
+            bool valid = false;
+            switch (node.kind) {
+            case NodeKind::NumericConst:
+                valid = node.arg[0] < tree.numbers_.size();
+                break;
+            case NodeKind::StringConst:
+                valid = node.arg[0] < tree.strings_.size();
+                break;
+            case NodeKind::BoolConst:
+            case NodeKind::None:
+                valid = true;
+                break;
+            case NodeKind::VariableValue:
+                valid = is_list && node.count > 0 && all_of(list, list + node.count, is_name);
+                break;
+            case NodeKind::Assignment:
+                valid = is_name(node.arg[0]) && is_child(node.arg[1]);
+                break;
+            case NodeKind::FieldAssignment:
+                valid = is_child(node.arg[0]) && is_name(node.arg[1]) && is_child(node.arg[2]);
+                break;
+            case NodeKind::Print:
+            case NodeKind::Compound:
+                valid = are_children();
+                break;
+            case NodeKind::MethodCall:
+            case NodeKind::Spawn:
+                valid = is_child(node.arg[0]) && is_name(node.arg[1]) && are_children();
+                break;
+            case NodeKind::NewInstance:
+                valid = node.arg[0] < tree.classes_.size() && are_children();
+                break;
+            case NodeKind::Stringify:
+            case NodeKind::Not:
+            case NodeKind::Return:
+            case NodeKind::NewChannel:
+            case NodeKind::Yield:
+                valid = is_child(node.arg[0]);
+                break;
+            case NodeKind::Add:
+            case NodeKind::Sub:
+            case NodeKind::Mult:
+            case NodeKind::Div:
+            case NodeKind::Or:
+            case NodeKind::And:
+                valid = is_child(node.arg[0]) && is_child(node.arg[1]);
+                break;
+            case NodeKind::Comparison:
+                valid = node.op < COMPARATOR_COUNT && is_child(node.arg[0]) && is_child(node.arg[1]);
+                break;
+            case NodeKind::ClassDefinition:
+                valid = node.arg[0] < tree.class_holders_.size();
+                break;
+            case NodeKind::IfElse:
+                valid = is_child(node.arg[0]) && is_child(node.arg[1])
+                    && (node.arg[2] == NO_NODE || is_child(node.arg[2]));
+                break;
+            }
+            if (!valid) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace flat_ast
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "flat_ast.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace flat_ast {
+
+    //      .         
+    //   :    ,   .  
+    //     , , ,   ,    
+    // . ,      ,    
+    //   .
+    //         ,   
+    //    ,   
+    class ProgramCache {
+    public:
+        //  .        Node
+        static constexpr uint32_t FORMAT_VERSION = 3;
+
+        //    (FNV-1a),     
+        [[nodiscard]] static uint64_t HashSource(std::string_view text);
+
+        //      source_path.  cache_dir ,   
+        //  ,  -  cache_dir      
+        [[nodiscard]] static std::string GetCachePath(const std::string& source_path, const std::string& cache_dir,
+            uint64_t source_hash);
+
+        //  program   path.      ,  
+        // ,        .
+        //  std::runtime_error   
+        static void Save(const Program& program, uint64_t source_hash, const std::string& path);
+
+        //     path.  nullptr,   ,   
+        //         
+        [[nodiscard]] static std::unique_ptr<Program> Load(const std::string& path, uint64_t source_hash);
+
+        //   program,  Save   
+        [[nodiscard]] static std::string Serialize(const Program& program, uint64_t source_hash);
+
+        //      text.    
+        //   text,  text   8   ,    
+        // owner.  nullptr    ,   Load
+        [[nodiscard]] static std::unique_ptr<Program> Deserialize(std::string_view text,
+            std::shared_ptr<const void> owner, uint64_t source_hash);
+
+    private:
+        // ,   tree     , ,   ,
+        //          .  
+        //          
+        [[nodiscard]] static bool CheckTree(const Tree& tree);
+    };
+
+}  // namespace flat_ast
@@ -0,0 +1,155 @@
+#include "execution_budget.h"
+#include "lexer.h"
+#include "parse.h"
+#include "program_cache.h"
+#include "test_runner_p.h"
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace flat_ast {
+
+    namespace {
+
+        //   source,     cache_path,     
+        // ,       .  true,  
+        //   
+        bool RunWithCache(const string& source, const string& cache_path, ostream& output) {
+            const uint64_t source_hash = ProgramCache::HashSource(source);
+            unique_ptr<runtime::Executable> program = ProgramCache::Load(cache_path, source_hash);
+            const bool cached = program != nullptr;
+            if (!cached) {
+                istringstream input(source);
+                parse::Lexer lexer(input);
+                program = ParseFlatProgram(lexer);
+                // ParseFlatProgram   flat_ast::Program
+                ProgramCache::Save(static_cast<const Program&>(*program), source_hash, cache_path);
+            }
+            runtime::SimpleContext context{ output };
+            runtime::Closure closure;
+            program->Execute(closure, context);
+            return cached;
+        }
+
+        void TestProgramCache() {
+            const auto dir = filesystem::temp_directory_path() / "mython_program_cache_test"s;
+            filesystem::create_directories(dir);
+            const string source = R"(
+class Greeter:
+  def greet(name):
+    return "Hello, " + name
+
+greeter = Greeter()
+print greeter.greet("cache")
+)"s;
+            const string cache_path = ProgramCache::GetCachePath((dir / "program.my"s).string(), dir.string(),
+                ProgramCache::HashSource(source));
+
+            ostringstream first;
+            ASSERT(!RunWithCache(source, cache_path, first));
+            ASSERT(filesystem::exists(cache_path));
+
+            ostringstream second;
+            ASSERT(RunWithCache(source, cache_path, second));
+            ASSERT_EQUAL(first.str(), "Hello, cache\n"s);
+            ASSERT_EQUAL(second.str(), first.str());
+
+            //       
+            ostringstream changed;
+            ASSERT(!RunWithCache("print 1\n"s, cache_path, changed));
+            ASSERT_EQUAL(changed.str(), "1\n"s);
+
+            filesystem::remove_all(dir);
+        }
+
+        void TestCorruptedCache() {
+            const string source = R"(
+class Counter:
+  def __init__(start):
+    self.value = start
+
+  def count(n):
+    if n > 0:
+      yield n
+      yield from self.count(n - 1)
+
+  def twice(n):
+    if n > 0:
+      return n * 2
+    else:
+      return 0
+
+  def __str__():
+    return "Counter " + str(self.value)
+
+c = Counter(3)
+c.value = c.value * 2 - 1 / 1
+ch = Channel(1)
+print c, c.count(2), c.twice(2), not 1 < 2 or True and False, None
+)"s;
+            const uint64_t source_hash = ProgramCache::HashSource(source);
+            istringstream input(source);
+            parse::Lexer lexer(input);
+            const auto program = ParseFlatProgram(lexer);
+            const string data = ProgramCache::Serialize(static_cast<const Program&>(*program), source_hash);
+            ASSERT(ProgramCache::Deserialize(data, nullptr, source_hash) != nullptr);
+
+            //       ,   , 
+            //        
+            size_t rejected = 0;
+            for (size_t i = 0; i < data.size(); ++i) {
+                for (const unsigned char mask : { 0x01, 0x80, 0xFF }) {
+                    string corrupted = data;
+                    corrupted[i] = static_cast<char>(corrupted[i] ^ mask);
+                    const auto loaded = ProgramCache::Deserialize(corrupted, nullptr, source_hash);
+                    if (!loaded) {
+                        ++rejected;
+                        continue;
+                    }
+                    ostringstream output;
+                    runtime::SimpleContext context{ output };
+                    runtime::ExecutionBudget budget(10'000);
+                    context.SetExecutionBudget(&budget);
+                    runtime::Closure closure;
+                    try {
+                        loaded->Execute(closure, context);
+                    }
+                    catch (const runtime_error&) {
+                    }
+                }
+            }
+            ASSERT(rejected > 0);
+
+            //    ,    uint64_t, ,  
+            // ,   .   node_count  data_offset    32- 
+            constexpr size_t COUNTS_POSITION = 32;
+            const auto patched = [&data](size_t field, uint64_t value) {
+                string corrupted = data;
+                memcpy(corrupted.data() + COUNTS_POSITION + field * sizeof(uint64_t), &value, sizeof(value));
+                return corrupted;
+            };
+            for (size_t field = 0; field < 5; ++field) {
+                for (const uint64_t value : { numeric_limits<uint64_t>::max() - 7, numeric_limits<uint64_t>::max() - 63,
+                         numeric_limits<uint64_t>::max() / 2 + 1 }) {
+                    ASSERT(ProgramCache::Deserialize(patched(field, value), nullptr, source_hash) == nullptr);
+                }
+            }
+            // nodes_offset
+            ASSERT(ProgramCache::Deserialize(patched(2, 0), nullptr, source_hash) == nullptr);
+            ASSERT(ProgramCache::Deserialize(patched(2, 8), nullptr, source_hash) == nullptr);
+        }
+
+    }  // namespace
+
+    void RunProgramCacheTests(TestRunner& tr) {
+        RUN_TEST(tr, flat_ast::TestProgramCache);
+        RUN_TEST(tr, flat_ast::TestCorruptedCache);
+    }
+
+}  // namespace flat_ast
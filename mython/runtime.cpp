@@ -1,5 +1,8 @@
 #include "runtime.h"
 
+#include "execution_budget.h"
+
+#include <algorithm>
 #include <cassert>
 #include <optional>
 #include <sstream>
@@ -13,6 +16,13 @@ namespace runtime {
         const string STR_METHOD = "__str__"s;
     }  // namespace
 
+    void Context::EnterCall() {
+        if (max_call_depth_ != 0 && call_depth_ >= max_call_depth_) {
+            throw BudgetExceededError("Maximum call depth of "s + to_string(max_call_depth_) + " exceeded"s);
+        }
+        ++call_depth_;
+    }
+
     ObjectHolder::ObjectHolder(std::shared_ptr<Object> data)
         : data_(std::move(data)) {
     }
@@ -22,8 +32,26 @@ namespace runtime {
     }
 
     ObjectHolder ObjectHolder::Share(Object& object) {
-        //   shared_ptr ( deleter   )
-        return ObjectHolder(std::shared_ptr<Object>(&object, [](auto* /*p*/) { /* do nothing */ }));
+        //  shared_ptr   :     
+        // ,  use_count    
+        return ObjectHolder(std::shared_ptr<Object>(std::shared_ptr<Object>(), &object));
+    }
+
+    ObjectHolder ObjectHolder::ShareConstant(const Object& object) {
+        return Share(const_cast<Object&>(object));
+    }
+
+    ObjectHolder ObjectHolder::ShareConstant(const Object& object, const std::shared_ptr<const void>& owner) {
+        // shared_ptr    owner     ,   owner
+        return ObjectHolder(std::shared_ptr<Object>(owner, const_cast<Object*>(&object)));
+    }
+
+    bool ObjectHolder::IsOwning() const {
+        return data_.use_count() != 0;
+    }
+
+    bool ObjectHolder::IsUnique() const {
+        return IsOwning() && data_.use_count() == 1;
     }
 
     ObjectHolder ObjectHolder::None() {
@@ -81,7 +109,12 @@ namespace runtime {
         if (HasMethod(STR_METHOD, 0)) {
             //cls_.GetMethod("__str__")->body->Execute(closure_, context);
             auto res = Call(STR_METHOD, {}, context);
-            res.Get()->Print(os, context);
+            if (res) {
+                res->Print(os, context);
+            }
+            else {
+                os << "None"sv;
+            }
         }
         else {
             os << this;
@@ -106,7 +139,17 @@ namespace runtime {
         return closure_;
     }
 
-    ClassInstance::ClassInstance(const Class& cls) : cls_(cls) {
+    ClassInstance::ClassInstance(const Class& cls, std::shared_ptr<const void> class_owner)
+        : cls_(cls)
+        , class_owner_(std::move(class_owner)) {
+    }
+
+    ObjectHolder ClassInstance::StartGenerator(const Method& method, Closure args) {
+        //       Call,   
+        if (shared_ptr<ClassInstance> self = weak_from_this().lock()) {
+            args["self"s] = ObjectHolder(std::move(self));
+        }
+        return ObjectHolder::Own(Generator(*method.body, std::move(args), class_owner_));
     }
 
     ObjectHolder ClassInstance::Call(const std::string& method,
@@ -121,13 +164,150 @@ namespace runtime {
             for (size_t i = 0; i < actual_args.size(); ++i) {
                 args[m->formal_params[i]] = actual_args[i];
             }
-            return m->body->Execute(args, context);
+            if (m->is_generator) {
+                return StartGenerator(*m, std::move(args));
+            }
+            context.EnterCall();
+            try {
+                ObjectHolder result = m->body->Execute(args, context);
+                context.LeaveCall();
+                return result;
+            }
+            catch (...) {
+                context.LeaveCall();
+                throw;
+            }
         }
         else {
             throw std::runtime_error("Not implemented"s);
         }
     }
 
+    Generator::Generator(const Executable& body, Closure closure, std::shared_ptr<const void> body_owner)
+        : body_(&body)
+        , body_owner_(std::move(body_owner))
+        , closure_(std::move(closure)) {
+    }
+
+    void Generator::Print(std::ostream& os, Context& context) {
+        for (bool first = true; HasNext(context); first = false) {
+            if (!first) {
+                os << ' ';
+            }
+            ObjectHolder value = Next(context);
+            if (value) {
+                value->Print(os, context);
+            }
+            else {
+                os << "None"sv;
+            }
+        }
+    }
+
+    ObjectHolder Generator::Next(Context& context) {
+        if (!next_ && !Advance(context)) {
+            return {};
+        }
+        ObjectHolder value = std::move(*next_);
+        next_.reset();
+        return value;
+    }
+
+    bool Generator::HasNext(Context& context) {
+        return next_ || Advance(context);
+    }
+
+    ObjectHolder Generator::Call(const std::string& method, const std::vector<ObjectHolder>& args, Context& context) {
+        if (method == "next"sv && args.empty()) {
+            return Next(context);
+        }
+        if (method == "has_next"sv && args.empty()) {
+            return ObjectHolder::Own(Bool(HasNext(context)));
+        }
+        throw runtime_error("Generator has no method "s + method + " with "s + to_string(args.size()) + " arguments"s);
+    }
+
+    bool Generator::Advance(Context& context) {
+        while (true) {
+            if (next_) {
+                return true;
+            }
+            if (finished_) {
+                return false;
+            }
+            if (running_) {
+                throw runtime_error("Generator is already running"s);
+            }
+            if (delegate_) {
+                auto* delegate = delegate_.TryAs<Generator>();
+                if (delegate->HasNext(context)) {
+                    next_ = delegate->Next(context);
+                    return true;
+                }
+                delegate_ = {};
+            }
+
+            running_ = true;
+            frame_.resuming = started_;
+            frame_.suspended = false;
+            frame_.delegate = false;
+            try {
+                body_->Resume(closure_, context, frame_);
+            }
+            catch (...) {
+                running_ = false;
+                finished_ = true;
+                closure_.clear();
+                throw;
+            }
+            running_ = false;
+            started_ = true;
+            if (!frame_.suspended) {
+                finished_ = true;
+                closure_.clear();
+                return false;
+            }
+
+            ObjectHolder value = std::move(frame_.value);
+            frame_.value = {};
+            if (!frame_.delegate) {
+                next_ = std::move(value);
+                return true;
+            }
+            auto* delegate = value.TryAs<Generator>();
+            if (!delegate || delegate == this) {
+                finished_ = true;
+                closure_.clear();
+                throw runtime_error("yield from requires another generator"s);
+            }
+            if (frame_.tail && value.IsUnique()) {
+                //     ,  delegate    , 
+                //      delegate,   
+                Adopt(*delegate);
+            }
+            else {
+                delegate_ = std::move(value);
+            }
+        }
+    }
+
+    void Generator::Adopt(Generator& other) {
+        if (other.running_) {
+            throw runtime_error("Generator is already running"s);
+        }
+        body_ = other.body_;
+        body_owner_ = other.body_owner_;
+        closure_ = std::move(other.closure_);
+        frame_ = std::move(other.frame_);
+        next_ = std::move(other.next_);
+        delegate_ = std::move(other.delegate_);
+        started_ = other.started_;
+        finished_ = other.finished_;
+        other.closure_.clear();
+        other.next_.reset();
+        other.finished_ = true;
+    }
+
     Class::Class(std::string name, std::vector<Method> methods, const Class* parent)
         :  name_(name), methods_(move(methods)), parent_(parent) {    
     }
@@ -151,6 +331,186 @@ namespace runtime {
         os << "Class " << name_;
     }
 
+    String::String(std::string value)
+        : size_(value.size()) {
+        if (IsInline()) {
+            value.copy(inline_, size_);
+        }
+        else {
+            shared_ = std::make_shared<const std::string>(std::move(value));
+        }
+    }
+
+    String::String(std::string_view value)
+        : size_(value.size()) {
+        if (IsInline()) {
+            value.copy(inline_, size_);
+        }
+        else {
+            shared_ = std::make_shared<const std::string>(value);
+        }
+    }
+
+    String::String(const char* value)
+        : String(std::string_view(value)) {
+    }
+
+    struct String::Rope {
+        String lhs;
+        String rhs;
+    };
+
+    String::String(const String& other)
+        : size_(other.size_), shared_(other.shared_), rope_(other.rope_)
+        , hash_(other.hash_.load(memory_order_relaxed)) {
+        std::copy(other.inline_, other.inline_ + INLINE_CAPACITY, inline_);
+    }
+
+    String::String(String&& other) noexcept
+        : size_(other.size_), shared_(std::move(other.shared_)), rope_(std::move(other.rope_))
+        , hash_(other.hash_.load(memory_order_relaxed)) {
+        std::copy(other.inline_, other.inline_ + INLINE_CAPACITY, inline_);
+        other.size_ = 0;
+    }
+
+    String& String::operator=(const String& other) {
+        if (this != &other) {
+            *this = String(other);
+        }
+        return *this;
+    }
+
+    String& String::operator=(String&& other) noexcept {
+        if (this != &other) {
+            ReleaseRope(std::move(rope_));
+            size_ = other.size_;
+            shared_ = std::move(other.shared_);
+            rope_ = std::move(other.rope_);
+            hash_.store(other.hash_.load(memory_order_relaxed), memory_order_relaxed);
+            std::copy(other.inline_, other.inline_ + INLINE_CAPACITY, inline_);
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    String::~String() {
+        ReleaseRope(std::move(rope_));
+    }
+
+    String String::Concat(const String& lhs, const String& rhs) {
+        if (rhs.size_ == 0) {
+            return lhs;
+        }
+        if (lhs.size_ == 0) {
+            return rhs;
+        }
+        const size_t size = lhs.size_ + rhs.size_;
+        if (size < MIN_ROPE_SIZE) {
+            const auto lhs_value = lhs.GetValue();
+            const auto rhs_value = rhs.GetValue();
+            std::string result;
+            result.reserve(size);
+            result.append(lhs_value).append(rhs_value);
+            return String(std::move(result));
+        }
+        String result;
+        result.size_ = size;
+        result.rope_ = std::make_shared<const Rope>(Rope{ lhs, rhs });
+        return result;
+    }
+
+    void String::Flatten() const {
+        std::string result;
+        result.reserve(size_);
+
+        //    :   s = s + piece    
+        std::vector<const String*> stack{ this };
+        while (!stack.empty()) {
+            const String* node = stack.back();
+            stack.pop_back();
+            if (node->rope_) {
+                stack.push_back(&node->rope_->rhs);
+                stack.push_back(&node->rope_->lhs);
+            }
+            else {
+                result.append(node->GetValue());
+            }
+        }
+
+        shared_ = std::make_shared<const std::string>(std::move(result));
+        ReleaseRope(std::move(rope_));
+    }
+
+    void String::ReleaseRope(std::shared_ptr<const Rope>&& rope) {
+        //     ,    rope     
+        if (!rope || rope.use_count() != 1) {
+            return;
+        }
+        // ,     ,   ,
+        //       
+        std::vector<std::shared_ptr<const Rope>> pending;
+        pending.push_back(std::move(rope));
+        while (!pending.empty()) {
+            std::shared_ptr<const Rope> node = std::move(pending.back());
+            pending.pop_back();
+            for (std::shared_ptr<const Rope>* child : { &node->lhs.rope_, &node->rhs.rope_ }) {
+                if (*child && child->use_count() == 1) {
+                    pending.push_back(std::move(*child));
+                }
+            }
+        }
+    }
+
+    void String::Print(std::ostream& os, [[maybe_unused]] Context& context) {
+        os << GetValue();
+    }
+
+    std::string_view String::GetValue() const {
+        if (IsInline()) {
+            return { inline_, size_ };
+        }
+        if (rope_) {
+            Flatten();
+        }
+        return *shared_;
+    }
+
+    size_t String::GetHash() const {
+        //    :        
+        size_t hash = hash_.load(memory_order_relaxed);
+        if (hash == 0) {
+            hash = std::hash<std::string_view>{}(GetValue());
+            if (hash == 0) {
+                hash = 1;
+            }
+            hash_.store(hash, memory_order_relaxed);
+        }
+        return hash;
+    }
+
+    bool operator==(const String& lhs, const String& rhs) {
+        if (lhs.size_ != rhs.size_) {
+            return false;
+        }
+        if ((lhs.shared_ && lhs.shared_ == rhs.shared_) || (lhs.rope_ && lhs.rope_ == rhs.rope_)) {
+            return true;
+        }
+        const size_t lhs_hash = lhs.hash_.load(memory_order_relaxed);
+        const size_t rhs_hash = rhs.hash_.load(memory_order_relaxed);
+        if (lhs_hash != 0 && rhs_hash != 0 && lhs_hash != rhs_hash) {
+            return false;
+        }
+        return lhs.GetValue() == rhs.GetValue();
+    }
+
+    bool operator!=(const String& lhs, const String& rhs) {
+        return !(lhs == rhs);
+    }
+
+    bool operator<(const String& lhs, const String& rhs) {
+        return lhs.GetValue() < rhs.GetValue();
+    }
+
     void Bool::Print(std::ostream& os, [[maybe_unused]] Context& context) {
         os << (GetValue() ? "True"sv : "False"sv);
     }
@@ -178,10 +538,7 @@ namespace runtime {
             auto t_lhs = lhs.TryAs<String>();
             auto t_rhs = rhs.TryAs<String>();
             if (t_lhs && t_rhs) {
-                if (t_lhs->GetValue() == t_rhs->GetValue()) {
-                    return true;
-                }
-                return false;
+                return *t_lhs == *t_rhs;
             }
         }
         {
@@ -225,7 +582,7 @@ namespace runtime {
             auto t1 = lhs.TryAs<String>();
             auto t2 = rhs.TryAs<String>();
             if (t1 && t2) {
-                return t1->GetValue() < t2->GetValue();
+                return *t1 < *t2;
             }
         }
         {
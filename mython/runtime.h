@@ -1,21 +1,79 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace runtime {
 
+    class ExecutionBudget;
+    class HeapProfiler;
+    class TaskScheduler;
+
     //    Mython
     class Context {
     public:
         //      print
         virtual std::ostream& GetOutputStream() = 0;
 
+        //     nullptr,   
+        virtual HeapProfiler* GetHeapProfiler() {
+            return nullptr;
+        }
+
+        //      spawn  nullptr,   
+        //  
+        virtual TaskScheduler* GetTaskScheduler() {
+            return nullptr;
+        }
+
+        //     nullptr,    . 
+        //     ,    ,   
+        //  
+        ExecutionBudget* GetExecutionBudget() const {
+            return budget_;
+        }
+
+        void SetExecutionBudget(ExecutionBudget* budget) {
+            budget_ = budget;
+        }
+
+        //         :    
+        //  , SuspendableRun     .   
+        //    ,         8 
+        static constexpr size_t DEFAULT_MAX_CALL_DEPTH = 1000;
+
+        //     , 0 ( ) -  .
+        //       :   ,  
+        // 
+        size_t GetMaxCallDepth() const {
+            return max_call_depth_;
+        }
+
+        void SetMaxCallDepth(size_t depth) {
+            max_call_depth_ = depth;
+        }
+
+        //        . EnterCall  BudgetExceededError, 
+        //    
+        void EnterCall();
+        void LeaveCall() {
+            --call_depth_;
+        }
+
     protected:
         ~Context() = default;
+
+    private:
+        ExecutionBudget* budget_ = nullptr;
+        size_t call_depth_ = 0;
+        size_t max_call_depth_ = 0;
     };
 
     //       Mython
@@ -42,6 +100,13 @@ namespace runtime {
 
         //  ObjectHolder,    (  )
         [[nodiscard]] static ObjectHolder Share(Object& object);
+        //  ObjectHolder,    .    
+        // ,      ObjectHolder   ,  
+        // Object,  Print,  
+        [[nodiscard]] static ObjectHolder ShareConstant(const Object& object);
+        //  ,  ObjectHolder   owner,   , 
+        //  .       
+        [[nodiscard]] static ObjectHolder ShareConstant(const Object& object, const std::shared_ptr<const void>& owner);
         //   ObjectHolder,   None
         [[nodiscard]] static ObjectHolder None();
 
@@ -63,7 +128,16 @@ namespace runtime {
         //  true,  ObjectHolder  
         explicit operator bool() const;
 
+        //  true,  ObjectHolder  ,  false  None  ObjectHolder,
+        //   Share
+        [[nodiscard]] bool IsOwning() const;
+        //  true,  ObjectHolder        
+        [[nodiscard]] bool IsUnique() const;
+
     private:
+        friend class HeapProfiler;
+        friend class ClassInstance;
+
         explicit ObjectHolder(std::shared_ptr<Object> data);
         void AssertIsValid() const;
 
@@ -97,17 +171,107 @@ namespace runtime {
     //     , True     true.    - false.
     bool IsTrue(const ObjectHolder& object);
 
-    //       Mython
+    // ,     -. path -    yield 
+    //  :         if
+    struct GeneratorFrame {
+        std::vector<uint32_t> path;
+        //     path,     
+        bool resuming = false;
+        //  yield     value
+        bool suspended = false;
+        ObjectHolder value;
+        //   yield from: value - ,     
+        bool delegate = false;
+        //  yield from  ,    
+        bool tail = false;
+    };
+
+    //       Mython.     
+    // ,         ,
+    //     closure  context
     class Executable {
     public:
         virtual ~Executable() = default;
         //      closure,  context
         //     None
-        virtual ObjectHolder Execute(Closure& closure, Context& context) = 0;
+        virtual ObjectHolder Execute(Closure& closure, Context& context) const = 0;
+        //     -:    yield,  
+        // frame.suspended == true, ,  frame.resuming,   frame.path.
+        // ,     yield,   Execute
+        virtual ObjectHolder Resume(Closure& closure, Context& context, GeneratorFrame& /*frame*/) const {
+            return Execute(closure, context);
+        }
     };
 
-    //  
-    using String = ValueObject<std::string>;
+    //  .   Mython ,     
+    //   ,          .
+    //       .
+    //         (rope)   
+    //        ,   
+    //  s = s + piece  ,     
+    class String : public Object {
+    public:
+        String(std::string value);  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        String(std::string_view value);  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+        String(const char* value);  // NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+
+        String(const String& other);
+        String(String&& other) noexcept;
+        String& operator=(const String& other);
+        String& operator=(String&& other) noexcept;
+
+        ~String() override;
+
+        //  ,  lhs + rhs
+        [[nodiscard]] static String Concat(const String& lhs, const String& rhs);
+
+        void Print(std::ostream& os, Context& context) override;
+
+        //  rope   
+        [[nodiscard]] std::string_view GetValue() const;
+
+        [[nodiscard]] size_t GetSize() const {
+            return size_;
+        }
+
+        [[nodiscard]] size_t GetHash() const;
+
+        //     INLINE_CAPACITY    
+        static constexpr size_t INLINE_CAPACITY = 15;
+
+    private:
+        //      
+        static constexpr size_t MIN_ROPE_SIZE = 64;
+
+        struct Rope;
+
+        String() = default;
+
+        void Flatten() const;
+        static void ReleaseRope(std::shared_ptr<const Rope>&& rope);
+
+        [[nodiscard]] bool IsInline() const {
+            return size_ <= INLINE_CAPACITY;
+        }
+
+        size_t size_ = 0;
+        char inline_[INLINE_CAPACITY] = {};
+        //         shared_  rope_.
+        // Flatten()  rope_  shared_,  rope-  
+        //    .   rope  
+        mutable std::shared_ptr<const std::string> shared_;
+        mutable std::shared_ptr<const Rope> rope_;
+        // 0 ,     
+        mutable std::atomic<size_t> hash_{ 0 };
+
+        friend bool operator==(const String& lhs, const String& rhs);
+    };
+
+    //       ,    
+    bool operator==(const String& lhs, const String& rhs);
+    bool operator!=(const String& lhs, const String& rhs);
+    bool operator<(const String& lhs, const String& rhs);
+
     //  
     using Number = ValueObject<int>;
 
@@ -127,6 +291,8 @@ namespace runtime {
         std::vector<std::string> formal_params;
         //  
         std::unique_ptr<Executable> body;
+        //   yield:    ,   
+        bool is_generator = false;
     };
 
     // 
@@ -150,10 +316,13 @@ namespace runtime {
         const Class* parent_ = nullptr;
     };
 
-    //  
-    class ClassInstance : public Object {
+    //  . ,   ,  ,  
+    //   
+    class ClassInstance : public Object, public std::enable_shared_from_this<ClassInstance> {
     public:
-        explicit ClassInstance(const Class& cls);
+        // class_owner    cls,   ,    .
+        //      
+        explicit ClassInstance(const Class& cls, std::shared_ptr<const void> class_owner = nullptr);
 
         /*
          *      __str__,   os ,   .
@@ -177,9 +346,63 @@ namespace runtime {
         [[nodiscard]] Closure& Fields();
         //     Closure,   
         [[nodiscard]] const Closure& Fields() const;
+
+        [[nodiscard]] const Class& GetClass() const {
+            return cls_;
+        }
+
+        [[nodiscard]] const std::shared_ptr<const void>& GetClassOwner() const {
+            return class_owner_;
+        }
     private: 
+        //   - method.   Call,   Generator
+        //       
+        ObjectHolder StartGenerator(const Method& method, Closure args);
+
         const Class& cls_;
+        std::shared_ptr<const void> class_owner_;
+        Closure closure_;
+    };
+
+    //  -   ,  yield.     :
+    //          yield  .
+    //           .
+    // yield from g    g.   yield from  ,   g
+    //   ,     g,   
+    //   "yield i; yield from self.range(i + 1, n)"    
+    class Generator : public Object {
+    public:
+        // body_owner    ,  class_owner  ClassInstance
+        Generator(const Executable& body, Closure closure, std::shared_ptr<const void> body_owner = nullptr);
+
+        //       ,    
+        void Print(std::ostream& os, Context& context) override;
+
+        //     None,    
+        ObjectHolder Next(Context& context);
+        //  true,      .    
+        //    yield,      Next
+        bool HasNext(Context& context);
+
+        //   next()  has_next().     runtime_error
+        ObjectHolder Call(const std::string& method, const std::vector<ObjectHolder>& args, Context& context);
+
+    private:
+        //     yield.  false,   
+        bool Advance(Context& context);
+        //    other,   
+        void Adopt(Generator& other);
+
+        const Executable* body_;
+        std::shared_ptr<const void> body_owner_;
         Closure closure_;
+        GeneratorFrame frame_;
+        std::optional<ObjectHolder> next_;
+        // ,        yield from
+        ObjectHolder delegate_;
+        bool started_ = false;
+        bool finished_ = false;
+        bool running_ = false;
     };
 
     /*
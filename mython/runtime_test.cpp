@@ -1,3 +1,4 @@
+#include "heap_profiler.h"
 #include "runtime.h"
 #include "test_runner_p.h"
 
@@ -71,6 +72,53 @@ namespace runtime {
             ASSERT_EQUAL(word.GetValue(), "hello!"s);
         }
 
+        void TestStringSharing() {
+            const String short_word("short"s);
+            const String long_word("a string that does not fit inline"s);
+
+            const String short_copy = short_word;
+            const String long_copy = long_word;
+            ASSERT_EQUAL(short_copy.GetValue(), "short"s);
+            ASSERT_EQUAL(long_copy.GetValue(), "a string that does not fit inline"s);
+            //       
+            ASSERT(long_copy.GetValue().data() == long_word.GetValue().data());
+
+            ASSERT(long_word == long_copy);
+            ASSERT(long_word == String("a string that does not fit inline"sv));
+            ASSERT(long_word != String("a string that does not fit inlinE"sv));
+            ASSERT(short_word != String("shorter"s));
+            ASSERT_EQUAL(long_word.GetHash(), long_copy.GetHash());
+            ASSERT_EQUAL(short_word.GetHash(), String("short").GetHash());
+            ASSERT_EQUAL(String(""s).GetSize(), 0U);
+        }
+
+        void TestStringConcat() {
+            const String hello("Hello, "s);
+            const String world("world!"s);
+            ASSERT_EQUAL(String::Concat(hello, world).GetValue(), "Hello, world!"s);
+            ASSERT_EQUAL(String::Concat(String(""s), world).GetValue(), "world!"s);
+
+            //          ,   
+            const string piece = "0123456789"s;
+            String accumulated(""s);
+            String prefix(""s);
+            for (int i = 0; i < 100000; ++i) {
+                accumulated = String::Concat(accumulated, String(piece));
+                if (i == 9) {
+                    prefix = accumulated;
+                }
+            }
+            ASSERT_EQUAL(accumulated.GetSize(), piece.size() * 100000);
+            ASSERT_EQUAL(prefix.GetSize(), piece.size() * 10);
+
+            const auto value = accumulated.GetValue();
+            ASSERT_EQUAL(value.substr(0, piece.size()), piece);
+            ASSERT_EQUAL(value.substr(value.size() - piece.size()), piece);
+            ASSERT_EQUAL(prefix.GetValue(), value.substr(0, prefix.GetSize()));
+            ASSERT(accumulated == String(std::string(value)));
+            ASSERT(prefix < accumulated);
+        }
+
         void TestBool() {
             Bool t(true);
             ASSERT_EQUAL(t.GetValue(), true);
@@ -98,7 +146,7 @@ namespace runtime {
                 : body(std::move(body)) {
             }
 
-            ObjectHolder Execute(Closure& closure, Context& context) override {
+            ObjectHolder Execute(Closure& closure, Context& context) const override {
                 if (body) {
                     return body(closure, context);
                 }
@@ -527,6 +575,72 @@ namespace runtime {
             ASSERT_EQUAL(out.str(), "result"s);
 
             ASSERT_THROWS(instance.Call("missing_method"s, {}, ctx), runtime_error);
+
+            // __str__,  None,   None
+            vector<Method> none_methods;
+            none_methods.push_back({ "__str__", {}, make_unique<TestMethodBody>(nullptr) });
+            Class none_cls{ "NoneStr"s, move(none_methods), nullptr };
+            ClassInstance none_instance{ none_cls };
+            ostringstream none_out;
+            none_instance.Print(none_out, ctx);
+            ASSERT_EQUAL(none_out.str(), "None"s);
+        }
+
+        //    ,     prefix
+        HeapProfiler::Stats FindSiteStats(const HeapProfiler& profiler, const string& prefix) {
+            for (const auto& [name, stats] : profiler.GetStats()) {
+                if (name.compare(0, prefix.size(), prefix) == 0) {
+                    return stats;
+                }
+            }
+            throw runtime_error("No allocation site "s + prefix);
+        }
+
+        void TestHeapProfiler() {
+            Class cls{ "Point"s, {}, nullptr };
+
+            DummyContext plain;
+            ASSERT(plain.GetHeapProfiler() == nullptr);
+            ASSERT(Allocate(ClassInstance(cls), plain).TryAs<ClassInstance>() != nullptr);
+
+            ProfilingContext context(plain);
+            const HeapProfiler& profiler = *context.GetHeapProfiler();
+            const int site = 0;
+            {
+                ObjectHolder first = Allocate(ClassInstance(cls), context);
+                ObjectHolder second = Allocate(ClassInstance(cls), context);
+                ObjectHolder number = Allocate(Number(57), context, &site, "Add"sv);
+                ObjectHolder copy = first;
+                ASSERT_EQUAL(&copy.TryAs<ClassInstance>()->GetClass(), &cls);
+                ASSERT_EQUAL(number.TryAs<Number>()->GetValue(), 57);
+
+                ASSERT_EQUAL(profiler.GetStats().size(), 2U);
+                ASSERT_EQUAL(profiler.GetStats()[0].first, "ClassInstance Point"s);
+                const auto instances = FindSiteStats(profiler, "ClassInstance Point"s);
+                ASSERT_EQUAL(instances.live_count, 2U);
+                ASSERT_EQUAL(instances.live_bytes, 2 * sizeof(ClassInstance));
+                ASSERT_EQUAL(FindSiteStats(profiler, "Number at Add #1"s).live_count, 1U);
+            }
+            Allocate(String("a string that does not fit inline"s), context, &site, "Add"sv);
+            //        ,    
+            const int other_site = 0;
+            Allocate(Number(1), context, &other_site, "Add"sv);
+            Allocate(Number(2), context, &site, "Add"sv);
+
+            ASSERT_EQUAL(profiler.GetStats().size(), 4U);
+            ASSERT_EQUAL(FindSiteStats(profiler, "Number at Add #1"s).total_count, 2U);
+            ASSERT_EQUAL(FindSiteStats(profiler, "Number at Add #2"s).total_count, 1U);
+            //           
+            ASSERT_EQUAL(profiler.GetStats()[0].first, "ClassInstance Point"s);
+            ASSERT_EQUAL(profiler.GetStats()[3].first, "Number at Add #2"s);
+            for (const auto& [name, stats] : profiler.GetStats()) {
+                ASSERT_EQUAL(stats.live_count, 0U);
+                ASSERT_EQUAL(stats.live_bytes, 0U);
+            }
+            const auto instances = FindSiteStats(profiler, "ClassInstance Point"s);
+            ASSERT_EQUAL(instances.peak_count, 2U);
+            ASSERT_EQUAL(instances.total_count, 2U);
+            ASSERT_EQUAL(FindSiteStats(profiler, "String at Add #1"s).total_bytes, sizeof(String) + 33);
         }
         
     }  // namespace
@@ -534,12 +648,15 @@ namespace runtime {
     void RunObjectsTests(TestRunner& tr) {
         RUN_TEST(tr, runtime::TestNumber);
         RUN_TEST(tr, runtime::TestString);
+        RUN_TEST(tr, runtime::TestStringSharing);
+        RUN_TEST(tr, runtime::TestStringConcat);
         RUN_TEST(tr, runtime::TestBool);
         RUN_TEST(tr, runtime::TestMethodInvocation);
         RUN_TEST(tr, runtime::TestIsTrue);
         RUN_TEST(tr, runtime::TestComparison);
         RUN_TEST(tr, runtime::TestClass);
         RUN_TEST(tr, runtime::TestClassInstance);
+        RUN_TEST(tr, runtime::TestHeapProfiler);
     }
     
     void RunObjectHolderTests(TestRunner& tr) {
@@ -0,0 +1,330 @@
+#include "server.h"
+
+#include "execution_budget.h"
+#include "program_cache.h"
+#include "tasks.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace mython {
+
+#ifdef _WIN32
+
+    Server::Server(Options options)
+        : options_(std::move(options)) {
+        throw runtime_error("Unix domain sockets are not supported"s);
+    }
+
+    Server::~Server() = default;
+
+    void Server::Run() {
+    }
+
+    void Server::Stop() {
+    }
+
+#else
+
+    Server::Server(Options options)
+        : options_(std::move(options)) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.socket_path.empty() || options_.socket_path.size() >= sizeof(address.sun_path)) {
+            throw runtime_error("Invalid socket path "s + options_.socket_path);
+        }
+        options_.socket_path.copy(address.sun_path, options_.socket_path.size());
+
+        int wake[2];
+        if (pipe(wake) != 0) {
+            throw runtime_error("Can't create pipe: "s + strerror(errno));
+        }
+        wake_read_ = wake[0];
+        wake_write_ = wake[1];
+        listener_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener_ < 0) {
+            const int error = errno;
+            close(wake_read_);
+            close(wake_write_);
+            throw runtime_error("Can't create socket: "s + strerror(error));
+        }
+        unlink(options_.socket_path.c_str());
+        if (bind(listener_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || listen(listener_, SOMAXCONN) != 0) {
+            const int error = errno;
+            close(listener_);
+            close(wake_read_);
+            close(wake_write_);
+            throw runtime_error("Can't listen on socket "s + options_.socket_path + ": "s + strerror(error));
+        }
+
+        if (options_.worker_count == 0) {
+            options_.worker_count = max<size_t>(thread::hardware_concurrency(), 1);
+        }
+        for (size_t i = 0; i < options_.worker_count; ++i) {
+            workers_.emplace_back([this] {
+                RunWorker();
+            });
+        }
+    }
+
+    Server::~Server() {
+        Stop();
+        for (thread& worker : workers_) {
+            worker.join();
+        }
+        for (const auto& [connection, frame] : pending_) {
+            close(connection);
+        }
+        for (const int connection : idle_) {
+            close(connection);
+        }
+        close(listener_);
+        close(wake_read_);
+        close(wake_write_);
+        unlink(options_.socket_path.c_str());
+    }
+
+    void Server::Run() {
+        vector<pollfd> polled;
+        vector<pair<int, string>> completed;
+        vector<int> closed;
+        while (true) {
+            polled.clear();
+            polled.push_back({ wake_read_, POLLIN, 0 });
+            polled.push_back({ listener_, POLLIN, 0 });
+            {
+                lock_guard lock(mutex_);
+                if (stopping_) {
+                    return;
+                }
+                for (const int connection : idle_) {
+                    polled.push_back({ connection, POLLIN, 0 });
+                }
+            }
+            if (poll(polled.data(), polled.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw runtime_error("Can't wait for requests: "s + strerror(errno));
+            }
+
+            if (polled[0].revents != 0) {
+                char buffer[64];
+                [[maybe_unused]] const ssize_t count = read(wake_read_, buffer, sizeof(buffer));
+            }
+            int accepted = -1;
+            int accept_error = 0;
+            if (polled[1].revents != 0) {
+                accepted = accept(listener_, nullptr, nullptr);
+                accept_error = accepted < 0 ? errno : 0;
+            }
+            //   polled  ,       ,  
+            //    
+            completed.clear();
+            closed.clear();
+            for (size_t i = 2; i < polled.size(); ++i) {
+                if (polled[i].revents == 0) {
+                    continue;
+                }
+                const int connection = polled[i].fd;
+                try {
+                    auto reader = readers_.find(connection);
+                    if (reader == readers_.end()) {
+                        reader = readers_.emplace(connection, server_protocol::FrameReader{}).first;
+                    }
+                    if (reader->second.ReadAvailable(connection)) {
+                        completed.emplace_back(connection, reader->second.TakeFrame());
+                        readers_.erase(reader);
+                    }
+                }
+                catch (const exception&) {
+                    //      
+                    readers_.erase(connection);
+                    closed.push_back(connection);
+                }
+            }
+
+            lock_guard lock(mutex_);
+            if (stopping_) {
+                if (accepted >= 0) {
+                    close(accepted);
+                }
+                return;
+            }
+            if (accept_error != 0 && accept_error != EINTR && accept_error != ECONNABORTED) {
+                throw runtime_error("Can't accept connection: "s + strerror(accept_error));
+            }
+            if (accepted >= 0) {
+                idle_.push_back(accepted);
+            }
+            for (const int connection : closed) {
+                idle_.erase(find(idle_.begin(), idle_.end(), connection));
+                close(connection);
+            }
+            //        
+            for (auto& [connection, frame] : completed) {
+                idle_.erase(find(idle_.begin(), idle_.end(), connection));
+                pending_.emplace_back(connection, std::move(frame));
+            }
+            if (completed.size() == 1) {
+                connection_ready_.notify_one();
+            }
+            else if (completed.size() > 1) {
+                connection_ready_.notify_all();
+            }
+        }
+    }
+
+    void Server::Stop() {
+        {
+            lock_guard lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        //   
+        shutdown(listener_, SHUT_RDWR);
+        connection_ready_.notify_all();
+        Wake();
+    }
+
+    void Server::Wake() {
+        const char signal = 0;
+        [[maybe_unused]] const ssize_t count = write(wake_write_, &signal, 1);
+    }
+
+    void Server::RunWorker() {
+        //        
+        ostringstream output;
+        while (true) {
+            int connection;
+            string frame;
+            {
+                unique_lock lock(mutex_);
+                connection_ready_.wait(lock, [this] {
+                    return stopping_ || !pending_.empty();
+                });
+                if (stopping_) {
+                    return;
+                }
+                connection = pending_.front().first;
+                frame = std::move(pending_.front().second);
+                pending_.pop_front();
+            }
+            if (!Serve(connection, frame, output)) {
+                close(connection);
+                continue;
+            }
+            {
+                lock_guard lock(mutex_);
+                idle_.push_back(connection);
+            }
+            Wake();
+        }
+    }
+
+    bool Server::Serve(int connection, const std::string& frame, std::ostringstream& output) {
+        try {
+            ServerResponse response;
+            try {
+                response = Execute(server_protocol::DecodeRequest(frame), output);
+            }
+            catch (const exception& e) {
+                //  
+                response.ok = false;
+                response.error = e.what();
+            }
+            server_protocol::WriteFrame(connection, server_protocol::EncodeResponse(response));
+            return true;
+        }
+        catch (const exception&) {
+            //  ,   
+            return false;
+        }
+    }
+
+#endif
+
+    ServerResponse Server::Execute(const ServerRequest& request, std::ostringstream& output) {
+        ServerResponse response;
+        output.str({});
+        output.clear();
+        try {
+            const CompiledProgram program = GetProgram(request, response.program_id);
+            runtime::TaskScheduler scheduler{ output };
+            runtime::ExecutionBudget budget(options_.step_limit);
+            scheduler.GetContext().SetMaxCallDepth(options_.max_call_depth);
+            if (options_.step_limit != 0) {
+                scheduler.GetContext().SetExecutionBudget(&budget);
+                scheduler.SetTaskStepLimit(options_.step_limit);
+                if (options_.max_call_depth == 0) {
+                    scheduler.GetContext().SetMaxCallDepth(runtime::Context::DEFAULT_MAX_CALL_DEPTH);
+                }
+            }
+            runtime::Closure inputs;
+            inputs["stdin"s] = runtime::ObjectHolder::Own(runtime::String(request.input));
+            try {
+                mython::Run(program, scheduler.GetContext(), std::move(inputs));
+            }
+            catch (...) {
+                scheduler.Cancel(current_exception());
+            }
+            scheduler.Wait();
+        }
+        catch (const exception& e) {
+            response.ok = false;
+            response.error = e.what();
+        }
+        response.output = output.str();
+        return response;
+    }
+
+    CompiledProgram Server::GetProgram(const ServerRequest& request, uint64_t& program_id) {
+        program_id = request.script.empty() ? request.program_id : flat_ast::ProgramCache::HashSource(request.script);
+        {
+            lock_guard lock(cache_mutex_);
+            if (const auto it = programs_.find(program_id);
+                it != programs_.end() && (request.script.empty() || it->second.source == request.script)) {
+                recent_.splice(recent_.begin(), recent_, it->second.recent);
+                return it->second.program;
+            }
+        }
+        if (request.script.empty()) {
+            throw runtime_error("Unknown program id "s + to_string(program_id));
+        }
+
+        //    ,     
+        //      
+        CompiledProgram program = Compile(request.script);
+        lock_guard lock(cache_mutex_);
+        if (const auto it = programs_.find(program_id); it != programs_.end()) {
+            //     ,        
+            recent_.erase(it->second.recent);
+            programs_.erase(it);
+        }
+        while (!programs_.empty() && programs_.size() >= max<size_t>(options_.cache_capacity, 1)) {
+            programs_.erase(recent_.back());
+            recent_.pop_back();
+        }
+        recent_.push_front(program_id);
+        programs_.emplace(program_id, CachedProgram{ request.script, program, recent_.begin() });
+        return program;
+    }
+
+}  // namespace mython
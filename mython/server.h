@@ -0,0 +1,174 @@
+#pragma once
+
+#include "mython.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//  :    ,    Unix-
+//    .      ,  ,  
+// , -    .
+//   :  uint32_t      ,  
+//       
+namespace mython {
+
+    struct ServerRequest {
+        //  .  ,     program_id
+        std::string script;
+        uint64_t program_id = 0;
+        //        stdin
+        std::string input;
+    };
+
+    struct ServerResponse {
+        bool ok = true;
+        //  ,      ,   
+        uint64_t program_id = 0;
+        //  ,     
+        std::string output;
+        //       
+        std::string error;
+    };
+
+    //       . Read  false,  
+    //    ,         runtime_error
+    namespace server_protocol {
+        std::string EncodeRequest(const ServerRequest& request);
+        ServerRequest DecodeRequest(std::string_view data);
+        std::string EncodeResponse(const ServerResponse& response);
+        ServerResponse DecodeResponse(std::string_view data);
+
+        bool ReadFrame(int fd, std::string& data);
+        void WriteFrame(int fd, std::string_view data);
+
+        //        ,   .   
+        //      ,  ,   , 
+        //  
+        class FrameReader {
+        public:
+            //   fd    ,     .  true, 
+            //   .  runtime_error,   , 
+            //      
+            bool ReadAvailable(int fd);
+            //    ,  ReadAvailable   
+            std::string TakeFrame();
+
+        private:
+            //      
+            std::string buffer_;
+        };
+    }  // namespace server_protocol
+
+    //         .  Run  
+    //     ,        
+    //         .  
+    //       ,    , 
+    // ,    ,    .    
+    //   .         ;   
+    // ,     .     
+    //     spawn
+    class Server {
+    public:
+        struct Options {
+            std::string socket_path;
+            // 0 -    
+            size_t worker_count = 0;
+            //      
+            size_t cache_capacity = 256;
+            //         (. runtime::ExecutionBudget),
+            // 0 -  . ,  ,    
+            //   
+            uint64_t step_limit = 0;
+            //         . 0 -  step_limit
+            // runtime::Context::DEFAULT_MAX_CALL_DEPTH,   
+            size_t max_call_depth = 0;
+        };
+
+        //   socket_path,      ,  
+        //  .  std::runtime_error,     
+        explicit Server(Options options);
+        //      
+        ~Server();
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        //        Stop
+        void Run();
+        //     .   ,  
+        //   .     
+        void Stop();
+
+        //    ,   ,    output
+        ServerResponse Execute(const ServerRequest& request, std::ostringstream& output);
+
+    private:
+        struct CachedProgram {
+            std::string source;
+            CompiledProgram program;
+            std::list<uint64_t>::iterator recent;
+        };
+
+        //         program_id. 
+        //    runtime_error
+        CompiledProgram GetProgram(const ServerRequest& request, uint64_t& program_id);
+        void RunWorker();
+        //     frame     .  false, 
+        //    
+        bool Serve(int connection, const std::string& frame, std::ostringstream& output);
+        //    Run
+        void Wake();
+
+        Options options_;
+        int listener_ = -1;
+        // ,       Run
+        int wake_read_ = -1;
+        int wake_write_ = -1;
+
+        std::mutex mutex_;
+        std::condition_variable connection_ready_;
+        //        
+        std::deque<std::pair<int, std::string>> pending_;
+        // ,  
+        std::vector<int> idle_;
+        //   ,  .    Run
+        std::unordered_map<int, server_protocol::FrameReader> readers_;
+        bool stopping_ = false;
+        std::vector<std::thread> workers_;
+
+        std::mutex cache_mutex_;
+        std::unordered_map<uint64_t, CachedProgram> programs_;
+        //        
+        std::list<uint64_t> recent_;
+    };
+
+    //    .  
+    class ServerClient {
+    public:
+        //  std::runtime_error,       socket_path
+        explicit ServerClient(const std::string& socket_path);
+        ~ServerClient();
+
+        ServerClient(const ServerClient&) = delete;
+        ServerClient& operator=(const ServerClient&) = delete;
+
+        //     .     ,  
+        //    std::runtime_error
+        ServerResponse Execute(const ServerRequest& request);
+
+    private:
+        int socket_ = -1;
+    };
+
+}  // namespace mython
@@ -0,0 +1,240 @@
+#include "server.h"
+
+#include "binary_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//    .    ,   
+//      
+namespace mython {
+
+    namespace server_protocol {
+
+        namespace {
+            //         
+            constexpr uint32_t MAX_FRAME_SIZE = 1u << 30;
+        }  // namespace
+
+        std::string EncodeRequest(const ServerRequest& request) {
+            binary_io::Writer writer;
+            writer.WriteU64(request.program_id);
+            writer.Write(request.script);
+            writer.Write(request.input);
+            return std::move(writer.GetData());
+        }
+
+        ServerRequest DecodeRequest(std::string_view data) {
+            binary_io::Reader reader(data);
+            ServerRequest request;
+            request.program_id = reader.ReadU64();
+            request.script = reader.ReadText();
+            request.input = reader.ReadText();
+            return request;
+        }
+
+        std::string EncodeResponse(const ServerResponse& response) {
+            binary_io::Writer writer;
+            writer.Write(response.ok ? 1u : 0u);
+            writer.WriteU64(response.program_id);
+            writer.Write(response.output);
+            writer.Write(response.error);
+            return std::move(writer.GetData());
+        }
+
+        ServerResponse DecodeResponse(std::string_view data) {
+            binary_io::Reader reader(data);
+            ServerResponse response;
+            response.ok = reader.ReadU32() != 0;
+            response.program_id = reader.ReadU64();
+            response.output = reader.ReadText();
+            response.error = reader.ReadText();
+            return response;
+        }
+
+#ifdef _WIN32
+
+        bool ReadFrame(int, std::string&) {
+            throw runtime_error("Unix domain sockets are not supported"s);
+        }
+
+        void WriteFrame(int, std::string_view) {
+            throw runtime_error("Unix domain sockets are not supported"s);
+        }
+
+        bool FrameReader::ReadAvailable(int) {
+            throw runtime_error("Unix domain sockets are not supported"s);
+        }
+
+#else
+
+        namespace {
+            //  size .  false,      
+            bool ReadExactly(int fd, char* data, size_t size) {
+                size_t done = 0;
+                while (done < size) {
+                    const ssize_t count = recv(fd, data + done, size - done, 0);
+                    if (count < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (count < 0) {
+                        throw runtime_error("Can't read from socket: "s + strerror(errno));
+                    }
+                    if (count == 0) {
+                        if (done == 0) {
+                            return false;
+                        }
+                        throw runtime_error("Connection closed in the middle of a message"s);
+                    }
+                    done += static_cast<size_t>(count);
+                }
+                return true;
+            }
+
+            void WriteAll(int fd, const char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+                //          SIGPIPE
+                constexpr int FLAGS = MSG_NOSIGNAL;
+#else
+                constexpr int FLAGS = 0;
+#endif
+                while (size > 0) {
+                    const ssize_t count = send(fd, data, size, FLAGS);
+                    if (count < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (count < 0) {
+                        throw runtime_error("Can't write to socket: "s + strerror(errno));
+                    }
+                    data += count;
+                    size -= static_cast<size_t>(count);
+                }
+            }
+        }  // namespace
+
+        bool ReadFrame(int fd, std::string& data) {
+            uint32_t size;
+            if (!ReadExactly(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+                return false;
+            }
+            if (size > MAX_FRAME_SIZE) {
+                throw runtime_error("Message is too large"s);
+            }
+            data.resize(size);
+            if (size > 0 && !ReadExactly(fd, data.data(), size)) {
+                throw runtime_error("Connection closed in the middle of a message"s);
+            }
+            return true;
+        }
+
+        void WriteFrame(int fd, std::string_view data) {
+            if (data.size() > MAX_FRAME_SIZE) {
+                throw runtime_error("Message is too large"s);
+            }
+            //      ,      
+            string frame(sizeof(uint32_t), '\0');
+            const auto size = static_cast<uint32_t>(data.size());
+            memcpy(frame.data(), &size, sizeof(size));
+            frame.append(data);
+            WriteAll(fd, frame.data(), frame.size());
+        }
+
+        bool FrameReader::ReadAvailable(int fd) {
+            //     ,      
+            //  
+            char chunk[64 * 1024];
+            while (true) {
+                size_t size = sizeof(uint32_t);
+                if (buffer_.size() >= sizeof(uint32_t)) {
+                    uint32_t data_size;
+                    memcpy(&data_size, buffer_.data(), sizeof(data_size));
+                    if (data_size > MAX_FRAME_SIZE) {
+                        throw runtime_error("Message is too large"s);
+                    }
+                    size += data_size;
+                }
+                if (buffer_.size() == size) {
+                    return true;
+                }
+                const ssize_t count = recv(fd, chunk, min(sizeof(chunk), size - buffer_.size()), MSG_DONTWAIT);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    return false;
+                }
+                if (count < 0) {
+                    throw runtime_error("Can't read from socket: "s + strerror(errno));
+                }
+                if (count == 0) {
+                    throw runtime_error("Connection closed"s);
+                }
+                buffer_.append(chunk, static_cast<size_t>(count));
+            }
+        }
+
+#endif
+
+        std::string FrameReader::TakeFrame() {
+            string data = buffer_.substr(sizeof(uint32_t));
+            buffer_.clear();
+            return data;
+        }
+
+    }  // namespace server_protocol
+
+#ifdef _WIN32
+
+    ServerClient::ServerClient(const std::string&) {
+        throw runtime_error("Unix domain sockets are not supported"s);
+    }
+
+    ServerClient::~ServerClient() = default;
+
+#else
+
+    ServerClient::ServerClient(const std::string& socket_path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+            throw runtime_error("Invalid socket path "s + socket_path);
+        }
+        socket_path.copy(address.sun_path, socket_path.size());
+
+        socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (socket_ < 0) {
+            throw runtime_error("Can't create socket: "s + strerror(errno));
+        }
+        if (connect(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            const int error = errno;
+            close(socket_);
+            throw runtime_error("Can't connect to "s + socket_path + ": "s + strerror(error));
+        }
+    }
+
+    ServerClient::~ServerClient() {
+        close(socket_);
+    }
+
+#endif
+
+    ServerResponse ServerClient::Execute(const ServerRequest& request) {
+        server_protocol::WriteFrame(socket_, server_protocol::EncodeRequest(request));
+        string frame;
+        if (!server_protocol::ReadFrame(socket_, frame)) {
+            throw runtime_error("Server closed the connection"s);
+        }
+        return server_protocol::DecodeResponse(frame);
+    }
+
+}  // namespace mython
@@ -0,0 +1,129 @@
+#include "server.h"
+#include "test_runner_p.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace mython {
+
+    namespace {
+
+        void TestServer() {
+            const auto dir = filesystem::temp_directory_path() / "mython_server_test"s;
+            filesystem::create_directories(dir);
+            const string socket_path = (dir / "server.sock"s).string();
+            mython::Server server({ socket_path, 2, 2 });
+            thread acceptor([&server] {
+                server.Run();
+            });
+
+            {
+                mython::ServerClient client(socket_path);
+                const string script = R"(
+class Greeter:
+  def greet(name):
+    return "Hello, " + name
+
+g = Greeter()
+print g.greet(stdin)
+)"s;
+                mython::ServerResponse first = client.Execute({ script, 0, "world"s });
+                ASSERT(first.ok);
+                ASSERT_EQUAL(first.output, "Hello, world\n"s);
+
+                //      
+                mython::ServerResponse second = client.Execute({ {}, first.program_id, "server"s });
+                ASSERT(second.ok);
+                ASSERT_EQUAL(second.program_id, first.program_id);
+                ASSERT_EQUAL(second.output, "Hello, server\n"s);
+
+                mython::ServerResponse failed = client.Execute({ "print 1\nx = 1 / 0\n"s, 0, {} });
+                ASSERT(!failed.ok);
+                ASSERT_EQUAL(failed.output, "1\n"s);
+                ASSERT(!failed.error.empty());
+                ASSERT(!client.Execute({ "print (\n"s, 0, {} }).ok);
+                ASSERT(!client.Execute({ {}, first.program_id + 1, {} }).ok);
+
+                //     ,     
+                mython::ServerClient other(socket_path);
+                ASSERT_EQUAL(other.Execute({ "print stdin + stdin\n"s, 0, "ab"s }).output, "abab\n"s);
+                ASSERT_EQUAL(client.Execute({ script, 0, "again"s }).output, "Hello, again\n"s);
+            }
+
+            server.Stop();
+            acceptor.join();
+            ASSERT_THROWS(mython::ServerClient{ socket_path }, runtime_error);
+            filesystem::remove_all(dir);
+        }
+
+        //     ServerClient,     
+        int ConnectRaw(const string& socket_path) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            socket_path.copy(address.sun_path, socket_path.size());
+            const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            ASSERT(fd >= 0);
+            ASSERT_EQUAL(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+            return fd;
+        }
+
+        void TestStalledClient() {
+            const auto dir = filesystem::temp_directory_path() / "mython_server_stalled_test"s;
+            filesystem::create_directories(dir);
+            const string socket_path = (dir / "server.sock"s).string();
+            //       ,   
+            mython::Server server({ socket_path, 1, 2 });
+            thread acceptor([&server] {
+                server.Run();
+            });
+
+            string frame(sizeof(uint32_t), '\0');
+            const string request = server_protocol::EncodeRequest({ "print stdin\n"s, 0, "split"s });
+            const auto size = static_cast<uint32_t>(request.size());
+            memcpy(frame.data(), &size, sizeof(size));
+            frame += request;
+
+            const int stalled = ConnectRaw(socket_path);
+            ASSERT_EQUAL(send(stalled, frame.data(), 2, 0), 2);
+            const int split = ConnectRaw(socket_path);
+            const size_t half = frame.size() / 2;
+            ASSERT_EQUAL(send(split, frame.data(), half, 0), static_cast<ssize_t>(half));
+            {
+                mython::ServerClient client(socket_path);
+                ASSERT_EQUAL(client.Execute({ "print 42\n"s, 0, {} }).output, "42\n"s);
+            }
+
+            // ,   , ,   
+            this_thread::sleep_for(chrono::milliseconds(20));
+            const size_t rest = frame.size() - half;
+            ASSERT_EQUAL(send(split, frame.data() + half, rest, 0), static_cast<ssize_t>(rest));
+            string data;
+            ASSERT(server_protocol::ReadFrame(split, data));
+            const mython::ServerResponse response = server_protocol::DecodeResponse(data);
+            ASSERT(response.ok);
+            ASSERT_EQUAL(response.output, "split\n"s);
+
+            close(split);
+            close(stalled);
+            server.Stop();
+            acceptor.join();
+            filesystem::remove_all(dir);
+        }
+
+    }  // namespace
+
+    void RunServerTests(TestRunner& tr) {
+        RUN_TEST(tr, mython::TestServer);
+        RUN_TEST(tr, mython::TestStalledClient);
+    }
+
+}  // namespace mython
@@ -0,0 +1,300 @@
+#include "snapshot.h"
+
+#include "binary_io.h"
+#include "mapped_file.h"
+#include "program_cache.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+using binary_io::ALIGNMENT;
+
+namespace flat_ast {
+
+    namespace {
+        //  : ,         (
+        //  8 )   : ,  ,    
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint64_t source_hash;
+            uint64_t program_offset;
+            uint64_t program_size;
+            uint64_t heap_offset;
+            uint64_t file_size;
+        };
+
+        constexpr char MAGIC[8] = "MYTHONS";
+        constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        enum class ObjectKind : uint32_t {
+            Number,
+            String,
+            Bool,
+            Class,
+            Instance,
+        };
+
+        //    -       . None  NO_OBJECT
+        constexpr uint32_t NO_OBJECT = numeric_limits<uint32_t>::max();
+
+        //  ,    ,      
+        class HeapWriter {
+        public:
+            HeapWriter(binary_io::Writer& writer, const vector<runtime::ObjectHolder>& classes)
+                : writer_(writer) {
+                for (const runtime::ObjectHolder& cls : classes) {
+                    class_indices_.emplace(cls.Get(), static_cast<uint32_t>(class_indices_.size()));
+                }
+            }
+
+            void Write(const runtime::Closure& globals, string_view output) {
+                //   :   -   objects_
+                for (const auto& [name, value] : globals) {
+                    AddObject(value);
+                }
+                for (size_t i = 0; i < objects_.size(); ++i) {
+                    if (const auto* instance = dynamic_cast<const runtime::ClassInstance*>(objects_[i])) {
+                        for (const auto& [name, value] : instance->Fields()) {
+                            AddObject(value);
+                        }
+                    }
+                }
+
+                writer_.Write(static_cast<uint32_t>(objects_.size()));
+                for (runtime::Object* object : objects_) {
+                    WriteObject(*object);
+                }
+                for (runtime::Object* object : objects_) {
+                    if (const auto* instance = dynamic_cast<const runtime::ClassInstance*>(object)) {
+                        WriteClosure(instance->Fields());
+                    }
+                }
+                WriteClosure(globals);
+                writer_.Write(output);
+            }
+
+        private:
+            void AddObject(const runtime::ObjectHolder& value) {
+                if (value && object_indices_.emplace(value.Get(), static_cast<uint32_t>(objects_.size())).second) {
+                    objects_.push_back(value.Get());
+                }
+            }
+
+            uint32_t GetClassIndex(const runtime::Class& cls) const {
+                const auto it = class_indices_.find(&cls);
+                if (it == class_indices_.end()) {
+                    throw logic_error("Class "s + cls.GetName() + " is not defined in the prelude"s);
+                }
+                return it->second;
+            }
+
+            void WriteObject(runtime::Object& object) {
+                if (const auto* number = dynamic_cast<const runtime::Number*>(&object)) {
+                    writer_.Write(static_cast<uint32_t>(ObjectKind::Number));
+                    writer_.Write(static_cast<uint32_t>(number->GetValue()));
+                }
+                else if (const auto* str = dynamic_cast<const runtime::String*>(&object)) {
+                    writer_.Write(static_cast<uint32_t>(ObjectKind::String));
+                    writer_.Write(str->GetValue());
+                }
+                else if (const auto* boolean = dynamic_cast<const runtime::Bool*>(&object)) {
+                    writer_.Write(static_cast<uint32_t>(ObjectKind::Bool));
+                    writer_.Write(static_cast<uint32_t>(boolean->GetValue()));
+                }
+                else if (const auto* cls = dynamic_cast<const runtime::Class*>(&object)) {
+                    writer_.Write(static_cast<uint32_t>(ObjectKind::Class));
+                    writer_.Write(GetClassIndex(*cls));
+                }
+                else if (const auto* instance = dynamic_cast<const runtime::ClassInstance*>(&object)) {
+                    writer_.Write(static_cast<uint32_t>(ObjectKind::Instance));
+                    writer_.Write(GetClassIndex(instance->GetClass()));
+                }
+                else {
+                    throw runtime_error("Object of unsupported type can't be stored in a snapshot"s);
+                }
+            }
+
+            void WriteClosure(const runtime::Closure& closure) {
+                writer_.Write(static_cast<uint32_t>(closure.size()));
+                for (const auto& [name, value] : closure) {
+                    writer_.Write(name);
+                    writer_.Write(value ? object_indices_.at(value.Get()) : NO_OBJECT);
+                    writer_.Write(static_cast<uint32_t>(value.IsOwning()));
+                }
+            }
+
+            binary_io::Writer& writer_;
+            unordered_map<const runtime::Object*, uint32_t> class_indices_;
+            unordered_map<const runtime::Object*, uint32_t> object_indices_;
+            vector<runtime::Object*> objects_;
+        };
+
+        //    .  std::runtime_error,   
+        class HeapReader {
+        public:
+            HeapReader(binary_io::Reader& reader, const vector<runtime::ObjectHolder>& classes)
+                : reader_(reader)
+                , classes_(classes) {
+            }
+
+            void Read(Snapshot& snapshot) {
+                objects_.resize(reader_.ReadCount(2 * sizeof(uint32_t)));
+                owned_.assign(objects_.size(), false);
+                vector<runtime::ClassInstance*> instances;
+                for (runtime::ObjectHolder& object : objects_) {
+                    object = ReadObject();
+                    if (auto* instance = object.TryAs<runtime::ClassInstance>()) {
+                        instances.push_back(instance);
+                    }
+                }
+                for (runtime::ClassInstance* instance : instances) {
+                    ReadClosure(instance->Fields());
+                }
+                ReadClosure(snapshot.globals);
+                snapshot.output = reader_.ReadText();
+
+                //    
+                for (size_t i = 0; i < objects_.size(); ++i) {
+                    if (!owned_[i] && !objects_[i].TryAs<runtime::Class>()) {
+                        snapshot.pinned.push_back(objects_[i]);
+                    }
+                }
+            }
+
+        private:
+            runtime::ObjectHolder ReadObject() {
+                const auto kind = static_cast<ObjectKind>(reader_.ReadU32());
+                switch (kind) {
+                case ObjectKind::Number:
+                    return runtime::ObjectHolder::Own(runtime::Number(static_cast<int>(reader_.ReadU32())));
+                case ObjectKind::String:
+                    return runtime::ObjectHolder::Own(runtime::String(reader_.ReadText()));
+                case ObjectKind::Bool:
+                    return runtime::ObjectHolder::Own(runtime::Bool(reader_.ReadU32() != 0));
+                case ObjectKind::Class:
+                    return ReadClass();
+                case ObjectKind::Instance:
+                    return runtime::ObjectHolder::Own(runtime::ClassInstance(*ReadClass().TryAs<runtime::Class>()));
+                }
+                throw runtime_error("Unknown object kind in snapshot"s);
+            }
+
+            runtime::ObjectHolder ReadClass() {
+                const uint32_t index = reader_.ReadU32();
+                if (index >= classes_.size()) {
+                    throw runtime_error("Unknown class in snapshot"s);
+                }
+                return classes_[index];
+            }
+
+            void ReadClosure(runtime::Closure& closure) {
+                const uint32_t size = reader_.ReadCount(3 * sizeof(uint32_t));
+                for (uint32_t i = 0; i < size; ++i) {
+                    string name(reader_.ReadText());
+                    const uint32_t index = reader_.ReadU32();
+                    const bool owning = reader_.ReadU32() != 0;
+                    if (index == NO_OBJECT) {
+                        closure[std::move(name)] = runtime::ObjectHolder::None();
+                        continue;
+                    }
+                    if (index >= objects_.size()) {
+                        throw runtime_error("Unknown object in snapshot"s);
+                    }
+                    owned_[index] = owned_[index] || owning;
+                    closure[std::move(name)] = owning ? objects_[index] : runtime::ObjectHolder::Share(*objects_[index]);
+                }
+            }
+
+            binary_io::Reader& reader_;
+            const vector<runtime::ObjectHolder>& classes_;
+            vector<runtime::ObjectHolder> objects_;
+            vector<bool> owned_;
+        };
+    }  // namespace
+
+    std::optional<std::pair<std::string_view, std::string_view>> Snapshot::SplitSource(std::string_view text) {
+        for (size_t begin = 0; begin < text.size();) {
+            const size_t end = min(text.find('\n', begin), text.size());
+            string_view line = text.substr(begin, end - begin);
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+                line.remove_suffix(1);
+            }
+            if (line == MARKER) {
+                return pair{ text.substr(0, begin), text.substr(min(end + 1, text.size())) };
+            }
+            begin = end + 1;
+        }
+        return nullopt;
+    }
+
+    void Snapshot::Save(uint64_t source_hash, const std::string& path) const {
+        binary_io::Writer writer;
+        Header header{};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.source_hash = source_hash;
+        writer.Append(&header, sizeof(header));
+
+        header.program_offset = writer.Align();
+        const string program = ProgramCache::Serialize(*prelude, source_hash);
+        writer.Append(program.data(), program.size());
+        header.program_size = program.size();
+        header.heap_offset = writer.Align();
+        HeapWriter(writer, prelude->GetTree().GetClasses()).Write(globals, output);
+
+        string& data = writer.GetData();
+        header.file_size = data.size();
+        memcpy(data.data(), &header, sizeof(header));
+        binary_io::WriteFileAtomically(path, data);
+    }
+
+    std::optional<Snapshot> Snapshot::Load(const std::string& path, uint64_t source_hash) {
+        try {
+            auto file = make_shared<const parse::MappedFile>(path);
+            const string_view text = file->GetText();
+
+            Header header;
+            if (text.size() < sizeof(header)) {
+                return nullopt;
+            }
+            memcpy(&header, text.data(), sizeof(header));
+            if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FORMAT_VERSION
+                || header.byte_order != BYTE_ORDER_MARK || header.source_hash != source_hash
+                || header.file_size != text.size() || header.program_offset % ALIGNMENT != 0
+                || header.program_offset > header.heap_offset
+                || header.program_size > header.heap_offset - header.program_offset
+                || header.heap_offset > text.size()) {
+                return nullopt;
+            }
+
+            Snapshot snapshot;
+            snapshot.prelude = ProgramCache::Deserialize(
+                text.substr(header.program_offset, header.program_size), file, source_hash);
+            if (!snapshot.prelude) {
+                return nullopt;
+            }
+            binary_io::Reader reader(text.substr(header.heap_offset));
+            HeapReader(reader, snapshot.prelude->GetTree().GetClasses()).Read(snapshot);
+            return snapshot;
+        }
+        catch (const std::runtime_error&) {
+            return nullopt;
+        }
+    }
+
+    std::unordered_map<std::string, const runtime::Class*> Snapshot::GetClasses() const {
+        unordered_map<string, const runtime::Class*> result;
+        for (const runtime::ObjectHolder& holder : prelude->GetTree().GetClasses()) {
+            const auto* cls = holder.TryAs<runtime::Class>();
+            result.emplace(cls->GetName(), cls);
+        }
+        return result;
+    }
+
+}  // namespace flat_ast
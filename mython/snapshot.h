@@ -0,0 +1,58 @@
+#pragma once
+
+#include "flat_ast.h"
+#include "runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flat_ast {
+
+    //        - :  
+    //     ,  ,      
+    //  . ,   ,  ,     
+    //   ,        .
+    //    ,      ,   
+    struct Snapshot {
+        //   .     ;  
+        //        ,    
+        static constexpr uint32_t FORMAT_VERSION = 1;
+
+        //   ,     .  ,
+        //        
+        static constexpr std::string_view MARKER = "#snapshot";
+
+        //           MARKER.  nullopt,
+        //    .  MARKER     
+        [[nodiscard]] static std::optional<std::pair<std::string_view, std::string_view>> SplitSource(
+            std::string_view text);
+
+        //     path. source_hash -   .
+        //  std::runtime_error,      , 
+        //  ,    ,    .   
+        //  
+        void Save(uint64_t source_hash, const std::string& path) const;
+
+        //     path.  nullopt,   ,   
+        //        
+        [[nodiscard]] static std::optional<Snapshot> Load(const std::string& path, uint64_t source_hash);
+
+        //    
+        [[nodiscard]] std::unordered_map<std::string, const runtime::Class*> GetClasses() const;
+
+        //  .   ,     
+        std::unique_ptr<Program> prelude;
+        runtime::Closure globals;
+        std::string output;
+        //  ,        . 
+        //   ,     
+        std::vector<runtime::ObjectHolder> pinned;
+    };
+
+}  // namespace flat_ast
@@ -0,0 +1,133 @@
+#include "lexer.h"
+#include "parse.h"
+#include "program_cache.h"
+#include "snapshot.h"
+#include "test_runner_p.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace flat_ast {
+
+    namespace {
+
+        //   text,    snapshot_path   . 
+        //     ,  ,    
+        void RunWithSnapshot(const string& text, const string& snapshot_path, ostream& output) {
+            const auto [prelude_text, rest_text] = *Snapshot::SplitSource(text);
+            const uint64_t prelude_hash = ProgramCache::HashSource(prelude_text);
+            auto snapshot = Snapshot::Load(snapshot_path, prelude_hash);
+            if (!snapshot) {
+                snapshot.emplace();
+                istringstream prelude_input{ string(prelude_text) };
+                parse::Lexer lexer(prelude_input);
+                snapshot->prelude.reset(static_cast<Program*>(ParseFlatProgram(lexer).release()));
+                ostringstream prelude_output;
+                runtime::SimpleContext context{ prelude_output };
+                snapshot->prelude->Execute(snapshot->globals, context);
+                snapshot->output = prelude_output.str();
+                try {
+                    snapshot->Save(prelude_hash, snapshot_path);
+                }
+                catch (const runtime_error&) {
+                }
+            }
+            output << snapshot->output;
+
+            istringstream rest_input{ string(rest_text) };
+            parse::Lexer lexer(rest_input);
+            auto program = ParseProgramWithClasses(lexer, snapshot->GetClasses());
+            runtime::SimpleContext context{ output };
+            program->Execute(snapshot->globals, context);
+        }
+
+        void TestSnapshot() {
+            const auto dir = filesystem::temp_directory_path() / "mython_snapshot_test"s;
+            filesystem::create_directories(dir);
+            const string snapshot_path = (dir / "program.snapshot"s).string();
+            const string prelude = R"(
+class Config:
+  def __init__(name):
+    self.name = name
+    self.me = self
+    self.count = 0
+
+class Counter(Config):
+  def bump():
+    self.count = self.count + 1
+    return self.count
+
+shared = Counter("shared")
+alias = shared
+holder = Config("holder")
+holder.item = shared
+flag = True
+nothing = None
+print "prelude", shared.name
+)"s;
+            const string rest = R"(
+x = alias.bump()
+y = holder.item.bump()
+fresh = Counter("fresh")
+print x, y, shared.count, shared.me.name, flag, nothing, fresh.bump()
+)"s;
+            const string text = prelude + "#snapshot\n"s + rest;
+
+            ostringstream first;
+            RunWithSnapshot(text, snapshot_path, first);
+            ASSERT_EQUAL(first.str(), "prelude shared\n1 2 2 shared True None 1\n"s);
+
+            //       
+            auto snapshot = flat_ast::Snapshot::Load(snapshot_path, flat_ast::ProgramCache::HashSource(prelude));
+            ASSERT(snapshot.has_value());
+            ASSERT(snapshot->globals.at("shared"s).Get() == snapshot->globals.at("alias"s).Get());
+            auto* holder = snapshot->globals.at("holder"s).TryAs<runtime::ClassInstance>();
+            ASSERT(holder != nullptr);
+            ASSERT(holder->Fields().at("item"s).Get() == snapshot->globals.at("shared"s).Get());
+            ASSERT(holder->Fields().at("me"s).Get() == holder);
+            ASSERT(!holder->Fields().at("me"s).IsOwning());
+            ASSERT(snapshot->globals.at("Counter"s).TryAs<runtime::Class>() == snapshot->GetClasses().at("Counter"s));
+            ASSERT(!snapshot->globals.at("nothing"s));
+
+            ostringstream second;
+            RunWithSnapshot(text, snapshot_path, second);
+            ASSERT_EQUAL(second.str(), first.str());
+
+            //     
+            ostringstream changed;
+            RunWithSnapshot("print 1\n#snapshot\nprint 2\n"s, snapshot_path, changed);
+            ASSERT_EQUAL(changed.str(), "1\n2\n"s);
+
+            //       :   
+            // ,     
+            const string with_generator = R"(
+class Source:
+  def range(n):
+    yield n
+    yield n + 1
+
+s = Source()
+numbers = s.range(1)
+#snapshot
+print numbers
+)"s;
+            for (int run = 0; run < 2; ++run) {
+                ostringstream output;
+                RunWithSnapshot(with_generator, snapshot_path, output);
+                ASSERT_EQUAL(output.str(), "1 2\n"s);
+            }
+            ASSERT(flat_ast::Snapshot::Load(snapshot_path, flat_ast::ProgramCache::HashSource("print 1\n"s)).has_value());
+
+            filesystem::remove_all(dir);
+        }
+
+    }  // namespace
+
+    void RunSnapshotTests(TestRunner& tr) {
+        RUN_TEST(tr, flat_ast::TestSnapshot);
+    }
+
+}  // namespace flat_ast
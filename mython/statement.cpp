@@ -1,5 +1,9 @@
 #include "statement.h"
 
+#include "execution_budget.h"
+#include "heap_profiler.h"
+#include "tasks.h"
+
 #include <iostream>
 #include <sstream>
 
@@ -16,7 +20,7 @@ namespace ast {
         const string INIT_METHOD = "__init__"s;
     }  // namespace
 
-    ObjectHolder Assignment::Execute(Closure& closure, Context& context) {
+    ObjectHolder Assignment::Execute(Closure& closure, Context& context) const {
         // .   
         if (var_.size() > 0) {
             closure[var_] = rv_->Execute(closure, context);
@@ -36,7 +40,7 @@ namespace ast {
     VariableValue::VariableValue(std::vector<std::string> dotted_ids) : dotted_ids_(std::move(dotted_ids)) {
     }
 
-    ObjectHolder VariableValue::Execute(Closure& closure, Context& ) {
+    ObjectHolder VariableValue::Execute(Closure& closure, Context& ) const {
         // .   
         if (const auto it = closure.find(dotted_ids_[0]); it != closure.end()) {
             ObjectHolder obj = it->second;
@@ -79,7 +83,7 @@ namespace ast {
 
     //     print     ,  
     // context.GetOutputStream()
-    ObjectHolder Print::Execute(Closure& closure, Context& context) {
+    ObjectHolder Print::Execute(Closure& closure, Context& context) const {
         bool flag = false;
         for (const auto& arg : args_) {
             auto value = arg->Execute(closure, context);
@@ -106,39 +110,67 @@ namespace ast {
         // .   
     }
 
-    ObjectHolder MethodCall::Execute(Closure& closure, Context& context) {
+    ObjectHolder MethodCall::Execute(Closure& closure, Context& context) const {
+        runtime::ChargeStep(context);
         std::vector<runtime::ObjectHolder> args;
         for (const auto& arg : args_) {
             args.push_back(arg->Execute(closure, context));
         }
 
-        auto* cls = object_->Execute(closure, context).TryAs<runtime::ClassInstance>();
+        ObjectHolder object = object_->Execute(closure, context);
+        auto* cls = object.TryAs<runtime::ClassInstance>();
         if (!cls) {
+            if (auto* generator = object.TryAs<runtime::Generator>()) {
+                return generator->Call(method_, args, context);
+            }
+            if (auto* channel = object.TryAs<runtime::Channel>()) {
+                return channel->Call(method_, args, context);
+            }
             throw std::runtime_error("Cannot find class"s);
         }
 
         return cls->Call(method_, args, context);
     }
 
-    ObjectHolder Stringify::Execute(Closure& closure, Context& context) {
+    Spawn::Spawn(std::unique_ptr<Statement> object, std::string method,
+        std::vector<std::unique_ptr<Statement>> args)
+        : object_(std::move(object))
+        , method_(std::move(method))
+        , args_(std::move(args)) {
+    }
+
+    ObjectHolder Spawn::Execute(Closure& closure, Context& context) const {
+        std::vector<runtime::ObjectHolder> args;
+        for (const auto& arg : args_) {
+            args.push_back(arg->Execute(closure, context));
+        }
+        runtime::SpawnTask(context, object_->Execute(closure, context), method_, args);
+        return {};
+    }
+
+    ObjectHolder NewChannel::Execute(Closure& closure, Context& context) const {
+        return runtime::MakeChannel(argument_->Execute(closure, context));
+    }
+
+    ObjectHolder Stringify::Execute(Closure& closure, Context& context) const {
         // .   
         stringstream ss;
         
         auto a = argument_.get()->Execute(closure, context); //.Get()->Print(ss, context);
+        if (const auto* str = a.TryAs<runtime::String>()) {
+            //      
+            return runtime::Allocate(runtime::String(*str), context, this, "Stringify"sv);
+        }
         if (a) {
             a.Get()->Print(ss, context);
         }
         else {
             ss << "None";
         }
-        string s;
-        s = ss.str();
-
-        return ObjectHolder::Own(runtime::ValueObject<string>(s));
-        return{};
+        return runtime::Allocate(runtime::String(ss.str()), context, this, "Stringify"sv);
     }
 
-    ObjectHolder Add::Execute(Closure& closure, Context& context) {
+    ObjectHolder Add::Execute(Closure& closure, Context& context) const {
         // .   
         auto lhs = lhs_->Execute(closure, context);
         auto rhs = rhs_->Execute(closure, context);
@@ -147,14 +179,14 @@ namespace ast {
             auto t_lhs = lhs.TryAs<runtime::Number>();
             auto t_rhs = rhs.TryAs<runtime::Number>();
             if (t_lhs && t_rhs) {
-                return runtime::ObjectHolder::Own<runtime::Number>(t_lhs->GetValue() + t_rhs->GetValue());
+                return runtime::Allocate(runtime::Number(t_lhs->GetValue() + t_rhs->GetValue()), context, this, "Add"sv);
             }
         }
         {
             auto t_lhs = lhs.TryAs<runtime::String>();
             auto t_rhs = rhs.TryAs<runtime::String>();
             if (t_lhs && t_rhs) {
-                return runtime::ObjectHolder::Own<runtime::String>(t_lhs->GetValue() + t_rhs->GetValue());
+                return runtime::Allocate(runtime::String::Concat(*t_lhs, *t_rhs), context, this, "Add"sv);
             }
         }
         {
@@ -171,7 +203,7 @@ namespace ast {
         throw std::runtime_error("Ne to");
     }
 
-    ObjectHolder Sub::Execute(Closure& closure, Context& context) {
+    ObjectHolder Sub::Execute(Closure& closure, Context& context) const {
         auto lhs = lhs_->Execute(closure, context);
         auto rhs = rhs_->Execute(closure, context);
 
@@ -179,13 +211,13 @@ namespace ast {
             auto n1 = lhs.TryAs<runtime::Number>();
             auto n2 = rhs.TryAs<runtime::Number>();
 
-            return ObjectHolder::Own(runtime::Number(n1->GetValue() - n2->GetValue()));
+            return runtime::Allocate(runtime::Number(n1->GetValue() - n2->GetValue()), context, this, "Sub"sv);
         }
         
         throw std::runtime_error("Sub wrong"s);
     }
 
-    ObjectHolder Mult::Execute(Closure& closure, Context& context) {
+    ObjectHolder Mult::Execute(Closure& closure, Context& context) const {
         auto lhs = lhs_->Execute(closure, context);
         auto rhs = rhs_->Execute(closure, context);
 
@@ -193,13 +225,13 @@ namespace ast {
             auto n1 = lhs.TryAs<runtime::Number>();
             auto n2 = rhs.TryAs<runtime::Number>();
 
-            return ObjectHolder::Own(runtime::Number(n1->GetValue() * n2->GetValue()));
+            return runtime::Allocate(runtime::Number(n1->GetValue() * n2->GetValue()), context, this, "Mult"sv);
         }
 
         throw std::runtime_error("Mult wrong"s);
     }
 
-    ObjectHolder Div::Execute(Closure& closure, Context& context) {
+    ObjectHolder Div::Execute(Closure& closure, Context& context) const {
         auto lhs = lhs_->Execute(closure, context);
         auto rhs = rhs_->Execute(closure, context);
 
@@ -209,29 +241,67 @@ namespace ast {
             if (n2->GetValue() == 0) {
                 throw std::runtime_error("Div na 0"s);
             }
-            return ObjectHolder::Own(runtime::Number(n1->GetValue() / n2->GetValue()));
+            return runtime::Allocate(runtime::Number(n1->GetValue() / n2->GetValue()), context, this, "Div"sv);
         }
 
         throw std::runtime_error("Div wrong"s);
     }
 
-    ObjectHolder Compound::Execute(Closure& closure, Context& context) {
+    ObjectHolder Compound::Execute(Closure& closure, Context& context) const {
+        runtime::ExecutionBudget* budget = context.GetExecutionBudget();
         for (auto& a : args_) {
+            if (budget) {
+                budget->Charge();
+            }
             a->Execute(closure, context);
         }
 
         return {};
     }
 
-    ObjectHolder Return::Execute(Closure& closure, Context& context) {
+    ObjectHolder Compound::Resume(Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        size_t i = 0;
+        if (frame.resuming) {
+            i = frame.path.back();
+            frame.path.pop_back();
+        }
+        for (; i < args_.size(); ++i) {
+            args_[i]->Resume(closure, context, frame);
+            if (frame.suspended) {
+                frame.path.push_back(static_cast<uint32_t>(i));
+                frame.tail = frame.tail && i + 1 == args_.size();
+                break;
+            }
+        }
+        return {};
+    }
+
+    ObjectHolder Return::Execute(Closure& closure, Context& context) const {
         throw statement_->Execute(closure, context);
     }
 
+    ObjectHolder Yield::Execute(Closure& /*closure*/, Context& /*context*/) const {
+        throw std::runtime_error("yield outside a generator"s);
+    }
+
+    ObjectHolder Yield::Resume(Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        if (frame.resuming) {
+            //    ,    yield
+            frame.resuming = false;
+            return {};
+        }
+        frame.value = statement_->Execute(closure, context);
+        frame.suspended = true;
+        frame.delegate = delegate_;
+        frame.tail = true;
+        return {};
+    }
+
     ClassDefinition::ClassDefinition(ObjectHolder cls) : class_(std::move(cls)) {
         // .   
     }
 
-    ObjectHolder ClassDefinition::Execute(Closure& closure, Context& ) {
+    ObjectHolder ClassDefinition::Execute(Closure& closure, Context& ) const {
         closure[class_.TryAs<runtime::Class>()->GetName()] = class_;
         return class_;
     }
@@ -242,7 +312,7 @@ namespace ast {
     }
 
     //   object.field_name   rv
-    ObjectHolder FieldAssignment::Execute(Closure& closure, Context& context) {
+    ObjectHolder FieldAssignment::Execute(Closure& closure, Context& context) const {
         auto* cls = object_.Execute(closure, context).TryAs<runtime::ClassInstance>();
         if (!cls) {
             throw std::runtime_error("no class"s);
@@ -258,7 +328,7 @@ namespace ast {
         //   
     }
 
-    ObjectHolder IfElse::Execute(Closure& closure, Context& context) {
+    ObjectHolder IfElse::Execute(Closure& closure, Context& context) const {
         if (runtime::IsTrue(condition_->Execute(closure, context))) {
             return if_body_->Execute(closure, context);
         }
@@ -269,7 +339,27 @@ namespace ast {
         return {};
     }
 
-    ObjectHolder Or::Execute(Closure& closure, Context& context) {
+    ObjectHolder IfElse::Resume(Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        // ,    : 0 - if, 1 - else
+        uint32_t branch = 0;
+        if (frame.resuming) {
+            branch = frame.path.back();
+            frame.path.pop_back();
+        }
+        else if (!runtime::IsTrue(condition_->Execute(closure, context))) {
+            branch = 1;
+        }
+        const Statement* body = branch == 0 ? if_body_.get() : else_body_.get();
+        if (body) {
+            body->Resume(closure, context, frame);
+            if (frame.suspended) {
+                frame.path.push_back(branch);
+            }
+        }
+        return {};
+    }
+
+    ObjectHolder Or::Execute(Closure& closure, Context& context) const {
         // .   
         auto lhs = lhs_.get()->Execute(closure, context);
         if (!lhs.TryAs<runtime::Bool>()->GetValue()) {
@@ -280,7 +370,7 @@ namespace ast {
 
     }
 
-    ObjectHolder And::Execute(Closure& closure, Context& context) {
+    ObjectHolder And::Execute(Closure& closure, Context& context) const {
         auto lhs = lhs_.get()->Execute(closure, context);
 
         if (lhs.TryAs<runtime::Bool>()->GetValue()) {
@@ -290,7 +380,7 @@ namespace ast {
         return ObjectHolder::Own<runtime::Bool>(false);
     }
 
-    ObjectHolder Not::Execute(Closure& closure, Context& context) {
+    ObjectHolder Not::Execute(Closure& closure, Context& context) const {
         auto arg = argument_.get()->Execute(closure, context);
 
         return ObjectHolder::Own<runtime::Bool>(!(arg.TryAs<runtime::Bool>()->GetValue()));
@@ -301,7 +391,7 @@ namespace ast {
         //   
     }
 
-    ObjectHolder Comparison::Execute(Closure& closure, Context& context) {
+    ObjectHolder Comparison::Execute(Closure& closure, Context& context) const {
         return ObjectHolder::Own(runtime::Bool(cmp_(lhs_->Execute(closure, context), 
             rhs_->Execute(closure, context), context)));
     }
@@ -313,8 +403,8 @@ namespace ast {
     NewInstance::NewInstance(const runtime::Class& class_) : class_(class_) {   
     }
 
-    ObjectHolder NewInstance::Execute(Closure& closure, Context& context) {
-        ObjectHolder obj = ObjectHolder::Own(runtime::ClassInstance(class_));
+    ObjectHolder NewInstance::Execute(Closure& closure, Context& context) const {
+        ObjectHolder obj = runtime::Allocate(runtime::ClassInstance(class_), context);
         auto new_instance = obj.TryAs<runtime::ClassInstance>();
         if (new_instance && new_instance->HasMethod("__init__", args_.size())) {
             std::vector<runtime::ObjectHolder> new_args;
@@ -329,7 +419,7 @@ namespace ast {
     MethodBody::MethodBody(std::unique_ptr<Statement>&& body) : body_(std::move(body)) {
     }
 
-    ObjectHolder MethodBody::Execute(Closure& closure, Context& context) {
+    ObjectHolder MethodBody::Execute(Closure& closure, Context& context) const {
         ObjectHolder res = ObjectHolder::None();
 
         try {
@@ -340,4 +430,14 @@ namespace ast {
         return res;
     }
 
+    ObjectHolder MethodBody::Resume(Closure& closure, Context& context, runtime::GeneratorFrame& frame) const {
+        try {
+            body_->Resume(closure, context, frame);
+        }
+        catch (ObjectHolder&) {
+            frame.suspended = false;
+        }
+        return {};
+    }
+
 }  // namespace ast
@@ -18,8 +18,8 @@ namespace ast {
         }
 
         runtime::ObjectHolder Execute(runtime::Closure& /*closure*/,
-            runtime::Context& /*context*/) override {
-            return runtime::ObjectHolder::Share(value_);
+            runtime::Context& /*context*/) const override {
+            return runtime::ObjectHolder::ShareConstant(value_);
         }
 
     private:
@@ -40,7 +40,7 @@ namespace ast {
         explicit VariableValue(const std::string& var_name);
         explicit VariableValue(std::vector<std::string> dotted_ids);
 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         std::vector<std::string> dotted_ids_;
     };
@@ -50,7 +50,7 @@ namespace ast {
     public:
         Assignment(std::string var, std::unique_ptr<Statement> rv);
 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         std::string var_;
         std::unique_ptr<Statement> rv_;
@@ -61,7 +61,7 @@ namespace ast {
     public:
         FieldAssignment(VariableValue object, std::string field_name, std::unique_ptr<Statement> rv);
 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         VariableValue object_;
         std::string field_name_;
@@ -72,7 +72,7 @@ namespace ast {
     class None : public Statement {
     public:
         runtime::ObjectHolder Execute([[maybe_unused]] runtime::Closure& closure,
-            [[maybe_unused]] runtime::Context& context) override {
+            [[maybe_unused]] runtime::Context& context) const override {
             return {};
         }
     };
@@ -90,7 +90,7 @@ namespace ast {
 
         //     print     ,  
         // context.GetOutputStream()
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         std::vector<std::unique_ptr<Statement>> args_;
     };
@@ -101,7 +101,20 @@ namespace ast {
         MethodCall(std::unique_ptr<Statement> object, std::string method,
             std::vector<std::unique_ptr<Statement>> args);
 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+    private:
+        std::unique_ptr<Statement> object_;
+        std::string method_;
+        std::vector<std::unique_ptr<Statement>> args_;
+    };
+
+    //   object.method   : spawn object.method(args).  
+    //    .  None
+    class Spawn : public Statement {
+    public:
+        Spawn(std::unique_ptr<Statement> object, std::string method, std::vector<std::unique_ptr<Statement>> args);
+
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         std::unique_ptr<Statement> object_;
         std::string method_;
@@ -126,7 +139,7 @@ namespace ast {
         explicit NewInstance(const runtime::Class& class_);
         NewInstance(const runtime::Class& class_, std::vector<std::unique_ptr<Statement>> args);
         //  ,    ClassInstance
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         const runtime::Class& class_;
         std::vector<std::unique_ptr<Statement>> args_;
@@ -146,7 +159,14 @@ namespace ast {
     class Stringify : public UnaryOperation {
     public:
         using UnaryOperation::UnaryOperation;
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+    };
+
+    //  Channel(capacity),       
+    class NewChannel : public UnaryOperation {
+    public:
+        using UnaryOperation::UnaryOperation;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //       lhs  rhs
@@ -171,7 +191,7 @@ namespace ast {
         //   + 
         //  1 + 2,   1 -     _add__(rhs)
         //       runtime_error
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //     lhs  rhs
@@ -182,7 +202,7 @@ namespace ast {
         //  :
         //   - 
         //  lhs  rhs -  ,   runtime_error
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //     lhs  rhs
@@ -193,7 +213,7 @@ namespace ast {
         //  :
         //   * 
         //  lhs  rhs -  ,   runtime_error
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //    lhs  rhs
@@ -205,7 +225,7 @@ namespace ast {
         //   / 
         //  lhs  rhs -  ,   runtime_error
         //  rhs  0,   runtime_error
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //      or  lhs  rhs
@@ -214,7 +234,7 @@ namespace ast {
         using BinaryOperation::BinaryOperation;
         //   rhs ,    lhs
         //    Bool  False
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //      and  lhs  rhs
@@ -223,14 +243,14 @@ namespace ast {
         using BinaryOperation::BinaryOperation;
         //   rhs ,    lhs
         //    Bool  True
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //      not    
     class Not : public UnaryOperation {
     public:
         using UnaryOperation::UnaryOperation;
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     };
 
     //   (:  ,   if,  else)
@@ -247,7 +267,9 @@ namespace ast {
             args_.push_back(std::move(stmt));
         }
         //    .  None
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
     private:
         std::vector<std::unique_ptr<Statement>> args_;
     };
@@ -260,7 +282,10 @@ namespace ast {
         //  ,    body.
         //   body    return,   return
         //     None
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        //      yield.  return  
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
     private:
         std::unique_ptr<Statement> body_;
     };
@@ -274,9 +299,28 @@ namespace ast {
 
         //    .    return ,
         //     ,      statement.
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+    private:
+        std::unique_ptr<Statement> statement_;
+    };
+
+    //  yield:   -,   statement
+    // ,     .      yield.
+    //  yield from (delegate == true)     statement
+    class Yield : public Statement {
+    public:
+        explicit Yield(std::unique_ptr<Statement> statement, bool delegate = false)
+            : statement_(std::move(statement))
+            , delegate_(delegate) {
+        }
+
+        //   yield  .  runtime_error
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
     private:
         std::unique_ptr<Statement> statement_;
+        bool delegate_;
     };
 
     //  
@@ -287,7 +331,7 @@ namespace ast {
 
         //   closure  ,      ,  
         // 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         runtime::ObjectHolder class_;
     };
@@ -299,7 +343,9 @@ namespace ast {
         IfElse(std::unique_ptr<Statement> condition, std::unique_ptr<Statement> if_body,
             std::unique_ptr<Statement> else_body);
 
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
+        runtime::ObjectHolder Resume(runtime::Closure& closure, runtime::Context& context,
+            runtime::GeneratorFrame& frame) const override;
     private:
         std::unique_ptr<Statement> condition_;
         std::unique_ptr<Statement> if_body_;
@@ -317,7 +363,7 @@ namespace ast {
 
         //    lhs  rhs     comparator,
         //    runtime::Bool
-        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) override;
+        runtime::ObjectHolder Execute(runtime::Closure& closure, runtime::Context& context) const override;
     private:
         Comparator cmp_;
     };
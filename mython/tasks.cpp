@@ -0,0 +1,486 @@
+#include "tasks.h"
+
+#include "execution_budget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <streambuf>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+        //      ,     
+        constexpr auto CANCEL_CHECK_PERIOD = chrono::milliseconds(20);
+
+        // ,      
+        thread_local TaskScheduler* current_scheduler = nullptr;
+
+        //   ,     
+        class Transfer {
+        public:
+            ObjectHolder Copy(const ObjectHolder& value) {
+                if (!value) {
+                    return {};
+                }
+                if (const auto* number = value.TryAs<Number>()) {
+                    return ObjectHolder::Own(Number(number->GetValue()));
+                }
+                if (const auto* boolean = value.TryAs<Bool>()) {
+                    return ObjectHolder::Own(Bool(boolean->GetValue()));
+                }
+                if (const auto* str = value.TryAs<String>()) {
+                    //   rope       
+                    static_cast<void>(str->GetValue());
+                    return ObjectHolder::Own(String(*str));
+                }
+                if (value.TryAs<Class>() || value.TryAs<Channel>()) {
+                    return value;
+                }
+                if (const auto* instance = value.TryAs<ClassInstance>()) {
+                    return CopyInstance(*instance);
+                }
+                throw runtime_error("Object can't be passed to another task"s);
+            }
+
+        private:
+            ObjectHolder CopyInstance(const ClassInstance& instance) {
+                if (const auto it = copies_.find(&instance); it != copies_.end()) {
+                    //         
+                    return in_progress_.count(&instance) ? ObjectHolder::Share(*it->second) : it->second;
+                }
+                ObjectHolder copy = ObjectHolder::Own(ClassInstance(instance.GetClass(), instance.GetClassOwner()));
+                copies_.emplace(&instance, copy);
+                in_progress_.insert(&instance);
+                Closure& fields = copy.TryAs<ClassInstance>()->Fields();
+                for (const auto& [name, field] : instance.Fields()) {
+                    fields.emplace(name, Copy(field));
+                }
+                in_progress_.erase(&instance);
+                return copy;
+            }
+
+            unordered_map<const ClassInstance*, ObjectHolder> copies_;
+            unordered_set<const ClassInstance*> in_progress_;
+        };
+    }  // namespace
+
+    ObjectHolder TransferObject(const ObjectHolder& value) {
+        return Transfer{}.Copy(value);
+    }
+
+    //  .           .
+    //   ,    ,     
+    class TaskScheduler::TaskContext : public Context {
+    public:
+        explicit TaskContext(TaskScheduler& scheduler, bool direct = false)
+            : scheduler_(scheduler)
+            , buffer_(scheduler, direct)
+            , stream_(&buffer_) {
+        }
+
+        TaskContext(const TaskContext&) = delete;
+        TaskContext& operator=(const TaskContext&) = delete;
+
+        ~TaskContext() {
+            buffer_.FlushAll();
+        }
+
+        std::ostream& GetOutputStream() override {
+            return stream_;
+        }
+
+        TaskScheduler* GetTaskScheduler() override {
+            return &scheduler_;
+        }
+
+        void Flush() {
+            buffer_.FlushAll();
+        }
+
+        //       .   ,  
+        //  ,         
+        void StopDirectOutput() {
+            buffer_.StopDirect();
+        }
+
+    private:
+        class LineBuffer : public streambuf {
+        public:
+            LineBuffer(TaskScheduler& scheduler, bool direct)
+                : scheduler_(scheduler)
+                , direct_(direct) {
+            }
+
+            void StopDirect() {
+                direct_ = false;
+            }
+
+            void FlushAll() {
+                if (!pending_.empty()) {
+                    scheduler_.WriteOutput(pending_);
+                    pending_.clear();
+                }
+            }
+
+        protected:
+            int_type overflow(int_type ch) override {
+                if (direct_ && !traits_type::eq_int_type(ch, traits_type::eof())) {
+                    scheduler_.output_.put(traits_type::to_char_type(ch));
+                }
+                else if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                    pending_.push_back(traits_type::to_char_type(ch));
+                    if (ch == '\n') {
+                        FlushAll();
+                    }
+                }
+                return traits_type::not_eof(ch);
+            }
+
+            streamsize xsputn(const char* s, streamsize count) override {
+                if (direct_) {
+                    scheduler_.output_.write(s, count);
+                    return count;
+                }
+                pending_.append(s, static_cast<size_t>(count));
+                if (memchr(s, '\n', static_cast<size_t>(count)) != nullptr) {
+                    const size_t end = pending_.rfind('\n') + 1;
+                    scheduler_.WriteOutput(string_view(pending_).substr(0, end));
+                    pending_.erase(0, end);
+                }
+                return count;
+            }
+
+            int sync() override {
+                FlushAll();
+                scheduler_.FlushOutput();
+                return 0;
+            }
+
+        private:
+            TaskScheduler& scheduler_;
+            //          
+            bool direct_;
+            string pending_;
+        };
+
+        TaskScheduler& scheduler_;
+        LineBuffer buffer_;
+        ostream stream_;
+    };
+
+    //        ,   
+    //  
+    template <typename Predicate>
+    void Channel::WaitUntil(unique_lock<mutex>& lock, condition_variable& cv, TaskScheduler* scheduler,
+        Predicate ready) {
+        if (ready()) {
+            return;
+        }
+        if (!scheduler) {
+            cv.wait(lock, ready);
+            return;
+        }
+        scheduler->BeginBlocking();
+        try {
+            while (!cv.wait_for(lock, CANCEL_CHECK_PERIOD, ready)) {
+                scheduler->ThrowIfCancelled();
+            }
+        }
+        catch (...) {
+            scheduler->EndBlocking();
+            throw;
+        }
+        scheduler->EndBlocking();
+    }
+
+    Channel::Channel(size_t capacity)
+        : state_(make_shared<State>()) {
+        if (capacity == 0) {
+            throw runtime_error("Channel capacity must be positive"s);
+        }
+        state_->capacity = capacity;
+    }
+
+    void Channel::Print(std::ostream& os, [[maybe_unused]] Context& context) {
+        os << "Channel"sv;
+    }
+
+    void Channel::Send(const ObjectHolder& value, Context& context) {
+        ObjectHolder item = TransferObject(value);
+        State& state = *state_;
+        {
+            unique_lock lock(state.mutex);
+            WaitUntil(lock, state.not_full, context.GetTaskScheduler(), [&state] {
+                return state.closed || state.items.size() < state.capacity;
+            });
+            if (state.closed) {
+                throw runtime_error("Send to a closed channel"s);
+            }
+            state.items.push_back(std::move(item));
+        }
+        state.not_empty.notify_one();
+    }
+
+    ObjectHolder Channel::Receive(Context& context) {
+        State& state = *state_;
+        ObjectHolder item;
+        {
+            unique_lock lock(state.mutex);
+            WaitUntil(lock, state.not_empty, context.GetTaskScheduler(), [&state] {
+                return state.closed || !state.items.empty();
+            });
+            if (state.items.empty()) {
+                return {};
+            }
+            item = std::move(state.items.front());
+            state.items.pop_front();
+        }
+        state.not_full.notify_one();
+        return item;
+    }
+
+    void Channel::Close() {
+        {
+            lock_guard lock(state_->mutex);
+            state_->closed = true;
+        }
+        state_->not_empty.notify_all();
+        state_->not_full.notify_all();
+    }
+
+    ObjectHolder Channel::Call(const std::string& method, const std::vector<ObjectHolder>& args, Context& context) {
+        if (method == "send"sv && args.size() == 1) {
+            Send(args.front(), context);
+            return {};
+        }
+        if (method == "receive"sv && args.empty()) {
+            return Receive(context);
+        }
+        if (method == "close"sv && args.empty()) {
+            Close();
+            return {};
+        }
+        throw runtime_error("Channel has no method "s + method + " with "s + to_string(args.size()) + " arguments"s);
+    }
+
+    ObjectHolder MakeChannel(const ObjectHolder& capacity) {
+        const auto* number = capacity.TryAs<Number>();
+        if (!number || number->GetValue() <= 0) {
+            throw runtime_error("Channel capacity must be a positive number"s);
+        }
+        return ObjectHolder::Own(Channel(static_cast<size_t>(number->GetValue())));
+    }
+
+    void SpawnTask(Context& context, const ObjectHolder& object, const std::string& method,
+        const std::vector<ObjectHolder>& args) {
+        TaskScheduler* scheduler = context.GetTaskScheduler();
+        if (!scheduler) {
+            throw runtime_error("spawn is not supported in this context"s);
+        }
+        scheduler->Spawn(object, method, args);
+    }
+
+    TaskScheduler::TaskScheduler(std::ostream& output, size_t thread_count)
+        : output_(output)
+        , main_context_(make_unique<TaskContext>(*this, true))
+        , thread_count_(thread_count != 0 ? thread_count : max(1u, thread::hardware_concurrency())) {
+    }
+
+    TaskScheduler::~TaskScheduler() {
+        {
+            unique_lock lock(mutex_);
+            all_done_.wait(lock, [this] {
+                return pending_ == 0;
+            });
+            stopping_ = true;
+        }
+        work_ready_.notify_all();
+        for (thread& worker : threads_) {
+            worker.join();
+        }
+        main_context_->Flush();
+    }
+
+    Context& TaskScheduler::GetContext() {
+        return *main_context_;
+    }
+
+    void TaskScheduler::SetTaskStepLimit(uint64_t limit) {
+        task_step_limit_ = limit;
+    }
+
+    void TaskScheduler::Spawn(const ObjectHolder& object, const std::string& method,
+        const std::vector<ObjectHolder>& args) {
+        const auto* instance = object.TryAs<ClassInstance>();
+        if (!instance || !instance->HasMethod(method, args.size())) {
+            throw runtime_error("Can't spawn method "s + method + " with "s + to_string(args.size()) + " arguments"s);
+        }
+        //     ,      
+        Transfer transfer;
+        Task task{ transfer.Copy(object), method, {} };
+        task.args.reserve(args.size());
+        for (const ObjectHolder& arg : args) {
+            task.args.push_back(transfer.Copy(arg));
+        }
+
+        lock_guard lock(mutex_);
+        if (!spawned_) {
+            //     ,    . , 
+            //     spawn,     
+            spawned_ = true;
+            main_context_->StopDirectOutput();
+        }
+        queue_.push_back(std::move(task));
+        ++pending_;
+        if (idle_ > 0) {
+            work_ready_.notify_one();
+        }
+        else if (workers_ - blocked_ < thread_count_) {
+            StartThread();
+        }
+    }
+
+    void TaskScheduler::Wait() {
+        main_context_->Flush();
+        unique_lock lock(mutex_);
+        all_done_.wait(lock, [this] {
+            return pending_ == 0;
+        });
+        if (error_) {
+            rethrow_exception(exchange(error_, nullptr));
+        }
+    }
+
+    void TaskScheduler::Cancel(std::exception_ptr error) {
+        lock_guard lock(mutex_);
+        if (!error_) {
+            error_ = std::move(error);
+        }
+    }
+
+    size_t TaskScheduler::GetExtraThreadCount() const {
+        lock_guard lock(mutex_);
+        return extra_threads_;
+    }
+
+    void TaskScheduler::BeginBlocking() {
+        //      
+        if (current_scheduler != this) {
+            return;
+        }
+        lock_guard lock(mutex_);
+        ++blocked_;
+        if (!queue_.empty() && idle_ == 0 && workers_ - blocked_ < thread_count_) {
+            ++extra_threads_;
+            StartThread();
+        }
+    }
+
+    void TaskScheduler::EndBlocking() {
+        if (current_scheduler != this) {
+            return;
+        }
+        lock_guard lock(mutex_);
+        --blocked_;
+    }
+
+    void TaskScheduler::ThrowIfCancelled() const {
+        lock_guard lock(mutex_);
+        if (error_) {
+            throw runtime_error("Task was cancelled because another task failed"s);
+        }
+    }
+
+    void TaskScheduler::StartThread() {
+        // ,    ,    mutex_
+        for (const thread::id id : exited_) {
+            const auto it = find_if(threads_.begin(), threads_.end(), [id](const thread& worker) {
+                return worker.get_id() == id;
+            });
+            it->join();
+            threads_.erase(it);
+        }
+        exited_.clear();
+        ++workers_;
+        threads_.emplace_back([this] {
+            RunWorker();
+        });
+    }
+
+    void TaskScheduler::RunWorker() {
+        current_scheduler = this;
+        unique_lock lock(mutex_);
+        while (true) {
+            // ,  ,  ,    
+            if (workers_ - blocked_ > thread_count_) {
+                --workers_;
+                exited_.push_back(this_thread::get_id());
+                return;
+            }
+            if (queue_.empty()) {
+                if (stopping_) {
+                    --workers_;
+                    return;
+                }
+                ++idle_;
+                work_ready_.wait(lock);
+                --idle_;
+                continue;
+            }
+            Task task = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+
+            exception_ptr error;
+            {
+                ExecutionBudget budget(task_step_limit_);
+                TaskContext context(*this);
+                //       ,     
+                context.SetMaxCallDepth(main_context_->GetMaxCallDepth());
+                if (task_step_limit_ != 0) {
+                    context.SetExecutionBudget(&budget);
+                    if (context.GetMaxCallDepth() == 0) {
+                        context.SetMaxCallDepth(Context::DEFAULT_MAX_CALL_DEPTH);
+                    }
+                }
+                try {
+                    task.object.TryAs<ClassInstance>()->Call(task.method, task.args, context);
+                }
+                catch (...) {
+                    error = current_exception();
+                }
+            }
+            task = {};
+
+            lock.lock();
+            Finish(std::move(error));
+        }
+    }
+
+    void TaskScheduler::Finish(std::exception_ptr error) {
+        if (error && !error_) {
+            error_ = std::move(error);
+        }
+        if (--pending_ == 0) {
+            all_done_.notify_all();
+        }
+    }
+
+    void TaskScheduler::WriteOutput(std::string_view text) {
+        lock_guard lock(output_mutex_);
+        output_.write(text.data(), static_cast<streamsize>(text.size()));
+    }
+
+    void TaskScheduler::FlushOutput() {
+        lock_guard lock(output_mutex_);
+        output_.flush();
+    }
+
+}  // namespace runtime
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "runtime.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//    Mython.  spawn object.method(args)    
+// ,       Channel(capacity).
+//     :    spawn,   , 
+//  ,         .  
+//   ,    
+namespace runtime {
+
+    class TaskScheduler;
+
+    //  value     .     
+    //     ,       
+    // ,   self.  ,   ,  runtime_error
+    ObjectHolder TransferObject(const ObjectHolder& value);
+
+    //     ,    
+    class Channel : public Object {
+    public:
+        //  capacity == 0  runtime_error
+        explicit Channel(size_t capacity);
+
+        //  "Channel"
+        void Print(std::ostream& os, Context& context) override;
+
+        //   value  ,   .   
+        //  runtime_error
+        void Send(const ObjectHolder& value, Context& context);
+        //  ,   .     ,  None
+        ObjectHolder Receive(Context& context);
+        //  : send    ,  receive   
+        //  None
+        void Close();
+
+        //   send(value), receive()  close().    
+        // runtime_error
+        ObjectHolder Call(const std::string& method, const std::vector<ObjectHolder>& args, Context& context);
+
+    private:
+        struct State {
+            std::mutex mutex;
+            std::condition_variable not_empty;
+            std::condition_variable not_full;
+            std::deque<ObjectHolder> items;
+            size_t capacity;
+            bool closed = false;
+        };
+
+        //   cv  ready
+        template <typename Predicate>
+        static void WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+            TaskScheduler* scheduler, Predicate ready);
+
+        //   Channel   
+        std::shared_ptr<State> state_;
+    };
+
+    //    capacity.  capacity -   , 
+    // runtime_error
+    ObjectHolder MakeChannel(const ObjectHolder& capacity);
+
+    //  spawn object.method(args)   context.   
+    //  ,  runtime_error
+    void SpawnTask(Context& context, const ObjectHolder& object, const std::string& method,
+        const std::vector<ObjectHolder>& args);
+
+    //      thread_count  (M   N ).  
+    //     .    ,        
+    // ,      ,    
+    //  .        output  ,  
+    //   ,     output ,   .
+    //    ,      ,  Wait
+    //   
+    class TaskScheduler {
+    public:
+        // thread_count == 0 -    .     spawn
+        explicit TaskScheduler(std::ostream& output, size_t thread_count = 0);
+        //   .      
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        //   
+        Context& GetContext();
+
+        //     object.method(args)     .   
+        //   ,  runtime_error
+        void Spawn(const ObjectHolder& object, const std::string& method, const std::vector<ObjectHolder>& args);
+
+        //    ,      .  
+        // ,    
+        void Wait();
+
+        //     ,   Wait  error. , 
+        //    ,       
+        void Cancel(std::exception_ptr error);
+
+        //   ,  spawn, limit   
+        //  (. ExecutionBudget), 0 -  .    spawn.
+        //       ,       
+        //  - Context::DEFAULT_MAX_CALL_DEPTH
+        void SetTaskStepLimit(uint64_t limit);
+
+        //  ,     
+        [[nodiscard]] size_t GetExtraThreadCount() const;
+
+    private:
+        friend class Channel;
+
+        struct Task {
+            ObjectHolder object;
+            std::string method;
+            std::vector<ObjectHolder> args;
+        };
+
+        class TaskContext;
+
+        //        
+        void BeginBlocking();
+        void EndBlocking();
+        //  runtime_error,     
+        void ThrowIfCancelled() const;
+
+        void StartThread();
+        void RunWorker();
+        void Finish(std::exception_ptr error);
+        //   text   
+        void WriteOutput(std::string_view text);
+        //  flush  output,      
+        void FlushOutput();
+
+        std::ostream& output_;
+        std::mutex output_mutex_;
+        std::unique_ptr<TaskContext> main_context_;
+        size_t thread_count_;
+        uint64_t task_step_limit_ = 0;
+
+        mutable std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable all_done_;
+        std::deque<Task> queue_;
+        std::vector<std::thread> threads_;
+        // ,    ;   
+        std::vector<std::thread::id> exited_;
+        size_t workers_ = 0;
+        size_t idle_ = 0;
+        size_t blocked_ = 0;
+        size_t extra_threads_ = 0;
+        //     
+        size_t pending_ = 0;
+        bool stopping_ = false;
+        //       .       output
+        // 
+        bool spawned_ = false;
+        std::exception_ptr error_;
+    };
+
+}  // namespace runtime
@@ -0,0 +1,187 @@
+#include "lexer.h"
+#include "mython.h"
+#include "parse.h"
+#include "tasks.h"
+#include "test_runner_p.h"
+
+#include <exception>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace runtime {
+
+    namespace {
+
+        //           
+        void RunWithTasks(istream& input, ostream& output) {
+            parse::Lexer lexer(input);
+            auto program = ParseProgram(lexer);
+            TaskScheduler scheduler{ output };
+            Closure closure;
+            try {
+                program->Execute(closure, scheduler.GetContext());
+            }
+            catch (...) {
+                scheduler.Cancel(current_exception());
+            }
+            scheduler.Wait();
+        }
+
+        void TestTasks() {
+            const string pipeline = R"(
+class Producer:
+  def run(out, i, n):
+    if i < n:
+      out.send(i)
+      self.run(out, i + 1, n)
+    else:
+      out.close()
+
+class Squarer:
+  def run(input, output):
+    x = input.receive()
+    if str(x) == "None":
+      output.close()
+    else:
+      output.send(x * x)
+      self.run(input, output)
+
+class Summer:
+  def sum(input, acc):
+    x = input.receive()
+    if str(x) == "None":
+      return acc
+    return self.sum(input, acc + x)
+
+class Counter:
+  def __init__():
+    self.total = 0
+    self.me = self
+
+  def add(n, out):
+    self.total = self.total + n
+    out.send(self)
+
+numbers = Channel(2)
+squares = Channel(2)
+s = Squarer()
+p = Producer()
+spawn s.run(numbers, squares)
+spawn p.run(numbers, 0, 10)
+summer = Summer()
+print summer.sum(squares, 0)
+
+c = Counter()
+results = Channel(1)
+spawn c.add(5, results)
+r = results.receive()
+print r.total, c.total, r.me.total
+)"s;
+            istringstream input(pipeline);
+            ostringstream output;
+            RunWithTasks(input, output);
+            ASSERT_EQUAL(output.str(), "285\n5 0 5\n"s);
+
+            //   : ,  ,    ,    
+            istringstream single_input(pipeline);
+            parse::Lexer lexer(single_input);
+            auto program = ParseFlatProgram(lexer);
+            ostringstream single_output;
+            {
+                runtime::TaskScheduler scheduler{ single_output, 1 };
+                runtime::Closure closure;
+                program->Execute(closure, scheduler.GetContext());
+                scheduler.Wait();
+            }
+            ASSERT_EQUAL(single_output.str(), "285\n5 0 5\n"s);
+
+            //       spawn   
+            istringstream print_input(R"(
+class Printer:
+  def run(n):
+    if n > 0:
+      print "line", n
+      self.run(n - 1)
+
+p = Printer()
+p.run(10)
+spawn p.run(50)
+spawn p.run(50)
+p.run(40)
+)"s);
+            ostringstream print_output;
+            RunWithTasks(print_input, print_output);
+            istringstream lines(print_output.str());
+            size_t line_count = 0;
+            for (string line; getline(lines, line); ++line_count) {
+                ASSERT_EQUAL(line.substr(0, 5), "line "s);
+            }
+            ASSERT_EQUAL(line_count, 150u);
+
+            //    ,    ,    
+            ostringstream direct_output;
+            TaskScheduler direct_scheduler{ direct_output };
+            direct_scheduler.GetContext().GetOutputStream() << "partial"sv;
+            ASSERT_EQUAL(direct_output.str(), "partial"s);
+            direct_scheduler.Wait();
+        }
+
+        void TestTaskErrors() {
+            //        
+            istringstream failing_task(R"(
+class Worker:
+  def run(out):
+    out.send(1 / 0)
+
+results = Channel(1)
+w = Worker()
+spawn w.run(results)
+x = results.receive()
+)"s);
+            ostringstream output;
+            ASSERT_THROWS(RunWithTasks(failing_task, output), runtime_error);
+
+            istringstream no_method(R"(
+class Worker:
+  def run():
+    return 1
+
+w = Worker()
+spawn w.stop()
+)"s);
+            ASSERT_THROWS(RunWithTasks(no_method, output), runtime_error);
+
+            istringstream no_object("spawn run()\n"s);
+            ASSERT_THROWS(RunWithTasks(no_object, output), ParseError);
+
+            istringstream closed(R"(
+c = Channel(1)
+c.close()
+c.send(1)
+)"s);
+            ASSERT_THROWS(RunWithTasks(closed, output), runtime_error);
+
+            //   spawn 
+            istringstream input(R"(
+class Worker:
+  def run():
+    return 1
+
+w = Worker()
+spawn w.run()
+)"s);
+            const mython::CompiledProgram program = mython::Compile(input.str());
+            runtime::SimpleContext context{ output };
+            ASSERT_THROWS(mython::Run(program, context), runtime_error);
+        }
+
+    }  // namespace
+
+    void RunTasksTests(TestRunner& tr) {
+        RUN_TEST(tr, runtime::TestTasks);
+        RUN_TEST(tr, runtime::TestTaskErrors);
+    }
+
+}  // namespace runtime